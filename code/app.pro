@@ -0,0 +1,45 @@
+QT       += core gui
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+CONFIG += c++11
+
+TARGET = cal
+
+include(engine/engine.pri)
+
+# You can make your code fail to compile if it uses deprecated APIs.
+# In order to do so, uncomment the following line.
+#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
+
+SOURCES += \
+    main.cpp \
+    buttons.cpp \
+    charsetvalidator.cpp \
+    input.cpp \
+    mainwindow.cpp \
+    result.cpp \
+    display.cpp \
+    evaluator.cpp \
+    expression.cpp \
+    trace.cpp \
+    update.cpp
+
+HEADERS += \
+    charsetvalidator.h \
+    evaluator.h \
+    mainwindow.h \
+    trace.h
+
+FORMS += \
+    mainwindow.ui
+
+TRANSLATIONS += \
+    cal_zh_CN.ts
+CONFIG += lrelease
+CONFIG += embed_translations
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
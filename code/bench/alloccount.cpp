@@ -0,0 +1,184 @@
+#include "alloccount.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<quint64> allocations{0};
+
+inline void countAllocation()
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace
+
+// glibc 导出了真正的实现，包装后转发即可，不需要 dlsym
+#if defined(__GLIBC__)
+#define BENCH_COUNT_MALLOC 1
+
+extern "C" {
+
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void *__libc_valloc(size_t size);
+void *__libc_pvalloc(size_t size);
+
+void *malloc(size_t size)
+{
+    countAllocation();
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    countAllocation();
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size)
+{
+    countAllocation();
+    return __libc_realloc(pointer, size);
+}
+
+// 按对齐分配的各个入口都经过 __libc_memalign 等，同样计数
+void *memalign(size_t alignment, size_t size)
+{
+    countAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+    countAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **pointer, size_t alignment, size_t size)
+{
+    // 对齐须为 2 的幂且是 sizeof(void *) 的倍数，不合法时不分配
+    if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0 || alignment == 0) return EINVAL;
+    countAllocation();
+    void *result = __libc_memalign(alignment, size);
+    if (!result) return ENOMEM;
+    *pointer = result;
+    return 0;
+}
+
+void *valloc(size_t size)
+{
+    countAllocation();
+    return __libc_valloc(size);
+}
+
+void *pvalloc(size_t size)
+{
+    countAllocation();
+    return __libc_pvalloc(size);
+}
+
+} // extern "C"
+#else
+#define BENCH_COUNT_MALLOC 0
+#endif
+
+namespace {
+
+// operator new 转发到 malloc；malloc 已被计数时不重复计数
+void *allocate(size_t size)
+{
+    if (!BENCH_COUNT_MALLOC) countAllocation();
+    return std::malloc(size ? size : 1);
+}
+
+} // namespace
+
+void *operator new(size_t size)
+{
+    void *pointer = allocate(size);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void *operator new[](size_t size)
+{
+    void *pointer = allocate(size);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept { return allocate(size); }
+void *operator new[](size_t size, const std::nothrow_t &) noexcept { return allocate(size); }
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete[](void *pointer) noexcept { std::free(pointer); }
+void operator delete(void *pointer, size_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { std::free(pointer); }
+void operator delete(void *pointer, const std::nothrow_t &) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept { std::free(pointer); }
+
+// C++17 的对齐 operator new（超过默认对齐的类型）：经 aligned_alloc 分配，glibc 上由上面的包装计数
+#ifdef __cpp_aligned_new
+namespace {
+
+void *allocateAligned(size_t size, std::align_val_t alignment)
+{
+    if (!BENCH_COUNT_MALLOC) countAllocation();
+    // aligned_alloc 要求大小是对齐的整数倍
+    const size_t align = size_t(alignment);
+    return std::aligned_alloc(align, (size + align - 1) / align * align + (size ? 0 : align));
+}
+
+} // namespace
+
+void *operator new(size_t size, std::align_val_t alignment)
+{
+    void *pointer = allocateAligned(size, alignment);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void *operator new[](size_t size, std::align_val_t alignment)
+{
+    void *pointer = allocateAligned(size, alignment);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return allocateAligned(size, alignment);
+}
+
+void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void *pointer, size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::align_val_t, const std::nothrow_t &) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::align_val_t, const std::nothrow_t &) noexcept { std::free(pointer); }
+#endif
+
+namespace bench {
+
+quint64 allocationCount()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+bool countsMalloc()
+{
+    return BENCH_COUNT_MALLOC;
+}
+
+} // namespace bench
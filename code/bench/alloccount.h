@@ -0,0 +1,22 @@
+#ifndef ALLOCCOUNT_H
+#define ALLOCCOUNT_H
+
+#include <QtGlobal>
+
+// -------------------------------
+// 堆分配计数：替换全局 operator new，基准用例据此统计每次调用的分配次数
+// Qt 容器（QString、QVector 等）直接调用 malloc，因此在 glibc 上同时接管 malloc/calloc/realloc，
+// 以及按对齐分配的 posix_memalign/aligned_alloc/memalign/valloc/pvalloc；C++17 的对齐 operator new 也计数
+// 非 glibc 平台只统计 operator new（含对齐版本）
+// -------------------------------
+namespace bench {
+
+// 进程启动以来的堆分配次数（只增不减，释放不计）
+quint64 allocationCount();
+
+// 分配是否经过 malloc 统计；为假时只统计 operator new
+bool countsMalloc();
+
+} // namespace bench
+
+#endif // ALLOCCOUNT_H
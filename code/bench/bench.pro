@@ -0,0 +1,32 @@
+QT = core
+
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+TARGET = bench
+
+include(../engine/engine.pri)
+
+# 默认语料目录指向源码树，可用 --corpus 覆盖
+DEFINES += BENCH_CORPUS_DIR=\\\"$$PWD/corpus\\\"
+
+SOURCES += \
+    main.cpp \
+    alloccount.cpp \
+    legacy.cpp
+
+HEADERS += \
+    alloccount.h \
+    legacy.h
+
+# make check-allocs：编译后以 --check-allocs 跑一遍全部用例，求值路径上的分配超出预期时失败
+allocs.target = check-allocs
+allocs.depends = $(TARGET)
+allocs.commands = $$shell_path($$OUT_PWD/$$TARGET) --check-allocs --min-time 20 > /dev/null
+# make check（在顶层运行时递归到各子项目）也运行它，分配检查因此是常规测试的一部分
+check.depends = check-allocs
+QMAKE_EXTRA_TARGETS += allocs check
+
+DISTFILES += \
+    corpus/expressions.txt \
+    corpus/split_rules.txt
@@ -0,0 +1,214 @@
+#include "legacy.h"
+
+namespace legacy {
+
+// 以下三个函数保持重构前的原样（逐字符 prepend、按字符串切分再 toLongLong）
+QString formatBinWithSpaces(const QString &bin)
+{
+    if (bin.isEmpty()) return bin;
+    
+    QString result;
+    // 从右到左每四位加一个空格
+    for (int i = bin.length() - 1; i >= 0; i--) {
+        if ((bin.length() - 1 - i) > 0 && (bin.length() - 1 - i) % 4 == 0) {
+            result.prepend(' ');
+        }
+        result.prepend(bin[i]);
+    }
+    return result;
+}
+
+QString formatBinWithSplit(const QString &bin, const QString &rule)
+{
+    if (rule.isEmpty() || bin.isEmpty()) return bin;
+
+    // 1. 解析规则并计算规则要求的总长度
+    QStringList ruleStrings = rule.split(',');
+    QList<int> lens;
+    int totalRuleLen = 0;
+    for (const QString& s : ruleStrings) {
+        bool ok;
+        int l = s.trimmed().toInt(&ok);
+        if (ok && l > 0) {
+            lens << l;
+            totalRuleLen += l;
+        }
+    }
+
+    if (lens.isEmpty()) return bin;
+
+    // 2. 补0逻辑：如果原始二进制长度不足规则总长，在高位（左侧）补0
+    QString paddedBin = bin;
+    if (bin.length() < totalRuleLen) {
+        paddedBin = bin.rightJustified(totalRuleLen, '0');
+    }
+
+    QStringList resultParts;
+    int currentLen = paddedBin.length();
+    int currentPos = 0;
+
+    // 3. 计算"规则外"的高位部分
+    // 如果 paddedBin 比 totalRuleLen 长（即用户规则只定义了低位的一部分），多出的高位作为第一段
+    int remainderLen = currentLen - totalRuleLen;
+    if (remainderLen > 0) {
+        QString firstSegment = paddedBin.left(remainderLen);
+        // 对第一段内部添加空格格式化
+        resultParts << formatBinWithSpaces(firstSegment);
+        currentPos = remainderLen;
+    }
+
+    // 4. 按照规则从高位向低位依次切分
+    // 此时由于已经补过0，规则定义的每一段都能取满
+    for (int l : lens) {
+        if (currentPos >= currentLen) break;
+        QString segment = paddedBin.mid(currentPos, l);
+        // 对每段内部添加空格格式化
+        resultParts << formatBinWithSpaces(segment);
+        currentPos += l;
+    }
+
+    return resultParts.join('|');
+}
+
+QStringList convertSplitParts(const QString &formattedBin, int base)
+{
+    QStringList parts;
+    const QStringList binParts = formattedBin.split('|');
+    for (const QString &part : binParts) {
+        if (part.isEmpty()) {
+            parts << "0";
+            continue;
+        }
+        bool ok;
+        // 注意：每一段都是一个独立的二进制数
+        // 移除空格以便解析
+        QString cleanPart = part;
+        cleanPart.remove(' ');
+        long long partVal = cleanPart.toLongLong(&ok, 2);
+        if (ok) {
+            QString text = QString::number(partVal, base);
+            parts << (base == 16 ? text.toUpper() : text);
+        }
+    }
+    return parts;
+}
+
+void formatDisplay(long long value, const QString &rule, DisplayStrings &out)
+{
+    out.dec = QString::number(value, 10);
+    out.hex = QString::number(value, 16).toUpper();
+    out.oct = QString::number(value, 8);
+    const QString rawBin = QString::number(value, 2);
+    out.bin = formatBinWithSpaces(rawBin);
+
+    out.binSplit = formatBinWithSplit(rawBin, rule);
+    if (rule.isEmpty() || !out.binSplit.contains('|')) {
+        out.decSplit = out.dec;
+        out.hexSplit = out.hex;
+        return;
+    }
+    out.decSplit = convertSplitParts(out.binSplit, 10).join('|');
+    out.hexSplit = convertSplitParts(out.binSplit, 16).join('|');
+}
+
+// 旧版输入框的解析：先 checkValueOverflow，再 toLongLong（switch 中的进制以基数表示）
+bool checkValueOverflow(const QString &text, int base)
+{
+    if (text.isEmpty()) return false;
+    
+    QString cleanText = text;
+    cleanText.remove(' '); // 移除空格
+    cleanText.remove('|'); // 移除分割符
+    
+    if (cleanText.isEmpty()) return false;
+    
+    // 64位无符号整数的最大值是 2^64 - 1 = 18446744073709551615
+    const unsigned long long MAX_64BIT = 9223372036854775808ULL;
+    
+    // 先检查字符串长度，如果明显超出，直接返回true
+    // 二进制：64位 = 64个字符
+    // 八进制：64位 = 22个字符 (1777777777777777777777)
+    // 十进制：64位 = 20个字符 (18446744073709551615)
+    // 十六进制：64位 = 16个字符 (FFFFFFFFFFFFFFFF)
+    int maxLength;
+    switch (base) {
+        case 2:
+            maxLength = 64;
+            // 移除前导0
+            while (cleanText.startsWith('0') && cleanText.length() > 1) {
+                cleanText.remove(0, 1);
+            }
+            if (cleanText.length() > maxLength) return true;
+            // 检查是否包含无效字符
+            for (QChar c : cleanText) {
+                if (c != '0' && c != '1') return false; // 无效字符，不认为是溢出
+            }
+            break;
+        case 8:
+            maxLength = 22;
+            while (cleanText.startsWith('0') && cleanText.length() > 1) {
+                cleanText.remove(0, 1);
+            }
+            if (cleanText.length() > maxLength) return true;
+            for (QChar c : cleanText) {
+                if (c < '0' || c > '7') return false;
+            }
+            break;
+        case 10:
+            maxLength = 20;
+            while (cleanText.startsWith('0') && cleanText.length() > 1) {
+                cleanText.remove(0, 1);
+            }
+            if (cleanText.length() > maxLength) return true;
+            for (QChar c : cleanText) {
+                if (c < '0' || c > '9') return false;
+            }
+            break;
+        case 16:
+            maxLength = 16;
+            cleanText = cleanText.toUpper();
+            while (cleanText.startsWith('0') && cleanText.length() > 1) {
+                cleanText.remove(0, 1);
+            }
+            if (cleanText.length() > maxLength) return true;
+            for (QChar c : cleanText) {
+                if (!((c >= '0' && c <= '9') || (c >= 'A' && c <= 'F'))) return false;
+            }
+            break;
+    }
+    
+    // 如果长度在范围内，尝试转换并比较值
+    bool ok;
+    unsigned long long value;
+    
+    switch (base) {
+        case 2:
+            value = cleanText.toULongLong(&ok, 2);
+            break;
+        case 8:
+            value = cleanText.toULongLong(&ok, 8);
+            break;
+        case 10:
+            value = cleanText.toULongLong(&ok, 10);
+            break;
+        case 16:
+            value = cleanText.toULongLong(&ok, 16);
+            break;
+    }
+    
+    // 如果转换失败，可能是无效字符，不认为是溢出
+    if (!ok) return false;
+    
+    // 比较值
+    return value > MAX_64BIT;
+}
+
+bool parseInput(const QString &text, int base, long long &value)
+{
+    if (text.isEmpty() || checkValueOverflow(text, base)) return false;
+    bool ok;
+    value = text.toLongLong(&ok, base);
+    return ok;
+}
+
+} // namespace legacy
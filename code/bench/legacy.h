@@ -0,0 +1,30 @@
+#ifndef LEGACY_H
+#define LEGACY_H
+
+#include <QString>
+#include <QStringList>
+
+// -------------------------------
+// 旧版基于字符串的格式化实现，仅作为基准测试的对照组
+// -------------------------------
+namespace legacy {
+
+QString formatBinWithSpaces(const QString &bin);
+QString formatBinWithSplit(const QString &bin, const QString &rule);
+QStringList convertSplitParts(const QString &formattedBin, int base);
+
+// 旧版 updateAllDisplays 生成的 7 个显示文本
+struct DisplayStrings
+{
+    QString dec, hex, oct, bin, binSplit, decSplit, hexSplit;
+};
+
+void formatDisplay(long long value, const QString &rule, DisplayStrings &out);
+
+// 旧版输入框的溢出检查与解析
+bool checkValueOverflow(const QString &text, int base);
+bool parseInput(const QString &text, int base, long long &value);
+
+} // namespace legacy
+
+#endif // LEGACY_H
@@ -0,0 +1,626 @@
+#include <QElapsedTimer>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+#include "alloccount.h"
+#include "bitfield.h"
+#include "bytecode.h"
+#include "calcapi.h"
+#include "column.h"
+#include "evalcache.h"
+#include "format.h"
+#include "legacy.h"
+#include "liveexpr.h"
+#include "radix.h"
+#include "splitlayout.h"
+#include "validator.h"
+
+#ifndef BENCH_CORPUS_DIR
+#define BENCH_CORPUS_DIR "corpus"
+#endif
+
+// -------------------------------
+// bench：引擎核心路径的微基准
+// 每个用例输出每次调用的平均耗时、吞吐和堆分配次数，可输出 CSV / JSON 供不同构建之间对比
+// 用法: bench [--format text|csv|json] [--corpus 目录] [--min-time 毫秒] [--check-allocs] [名称子串]
+// -------------------------------
+namespace {
+
+enum OutputFormat { TextOutput, CsvOutput, JsonOutput };
+
+struct Options
+{
+    OutputFormat format = TextOutput;
+    QString corpusDir = QStringLiteral(BENCH_CORPUS_DIR);
+    qint64 minDurationNs = 200 * 1000 * 1000;  // 每个用例至少运行的时间
+    const char *filter = "";
+    bool checkAllocations = false;             // 应当不分配内存的用例有分配时以退出码 1 结束
+};
+
+struct Result
+{
+    QString name;
+    qint64 ops = 0;          // 计时期间的调用次数
+    double nsPerOp = 0;
+    double opsPerSec = 0;
+    double bytesPerSec = 0;  // 输入文本的吞吐（按字符计），0 表示不适用
+    double allocsPerOp = 0;
+};
+
+// 语料中的一条表达式
+struct Expression
+{
+    int base = calc::DEC;
+    QString text;
+};
+
+// 累加每次结果，防止被优化掉
+volatile qint64 sink;
+
+void printUsage(FILE *out)
+{
+    fputs("用法: bench [选项] [名称子串]\n"
+          "\n"
+          "选项:\n"
+          "  --format <text|csv|json>   输出格式（默认 text）\n"
+          "  --corpus <目录>            语料目录（默认为源码中的 bench/corpus）\n"
+          "  --min-time <毫秒>          每个用例至少运行的时间（默认 200）\n"
+          "  --check-allocs             求值路径上应当不分配内存的用例有分配时以退出码 1 结束\n"
+          "  -h, --help                 显示本帮助\n", out);
+}
+
+bool parseArguments(int argc, char *argv[], Options &options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (!strcmp(arg, "-h") || !strcmp(arg, "--help")) {
+            printUsage(stdout);
+            exit(0);
+        } else if (!strcmp(arg, "--format") && value) {
+            if (!strcmp(value, "text")) options.format = TextOutput;
+            else if (!strcmp(value, "csv")) options.format = CsvOutput;
+            else if (!strcmp(value, "json")) options.format = JsonOutput;
+            else return false;
+            ++i;
+        } else if (!strcmp(arg, "--corpus") && value) {
+            options.corpusDir = QString::fromLocal8Bit(value);
+            ++i;
+        } else if (!strcmp(arg, "--min-time") && value) {
+            const int ms = atoi(value);
+            if (ms <= 0) return false;
+            options.minDurationNs = qint64(ms) * 1000 * 1000;
+            ++i;
+        } else if (!strcmp(arg, "--check-allocs")) {
+            options.checkAllocations = true;
+        } else if (arg[0] == '-') {
+            return false;
+        } else {
+            options.filter = arg;
+        }
+    }
+    return true;
+}
+
+// -------------------------------
+// 语料
+// -------------------------------
+
+// 读取语料文件的有效行（去掉首尾空白，跳过空行和 # 注释）
+bool readLines(const QString &path, QStringList &lines)
+{
+    FILE *file = fopen(path.toLocal8Bit().constData(), "rb");
+    if (!file) return false;
+
+    QByteArray data;
+    char chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) data.append(chunk, int(n));
+    fclose(file);
+
+    for (const QString &line : QString::fromUtf8(data).split(QLatin1Char('\n'))) {
+        const QString trimmed = line.trimmed();
+        if (!trimmed.isEmpty() && !trimmed.startsWith(QLatin1Char('#'))) lines << trimmed;
+    }
+    return true;
+}
+
+bool parseBase(const QString &name, int &base)
+{
+    if (name == QLatin1String("bin")) base = calc::BIN;
+    else if (name == QLatin1String("oct")) base = calc::OCT;
+    else if (name == QLatin1String("dec")) base = calc::DEC;
+    else if (name == QLatin1String("hex")) base = calc::HEX;
+    else return false;
+    return true;
+}
+
+// 每行 "<进制> <表达式>"，只有进制的行表示空表达式
+bool loadExpressions(const QString &path, QVector<Expression> &expressions)
+{
+    QStringList lines;
+    if (!readLines(path, lines)) return false;
+    for (const QString &line : lines) {
+        const int space = line.indexOf(QLatin1Char(' '));
+        Expression expression;
+        if (!parseBase(space < 0 ? line : line.left(space), expression.base)) return false;
+        if (space >= 0) expression.text = line.mid(space + 1);
+        expressions.append(expression);
+    }
+    return true;
+}
+
+// 每行一条规则，"-" 表示不分割
+bool loadSplitRules(const QString &path, QStringList &rules)
+{
+    if (!readLines(path, rules)) return false;
+    for (QString &rule : rules) {
+        if (rule == QLatin1String("-")) rule.clear();
+    }
+    return true;
+}
+
+QVector<qint64> makeValues()
+{
+    // 覆盖短数、满 64 位和负数
+    std::mt19937_64 rng(20240601);
+    QVector<qint64> values;
+    for (int i = 0; i < 4096; ++i) {
+        qint64 v = qint64(rng() >> (rng() % 64));
+        if (i % 4 == 0) v = -v;
+        values.append(v);
+    }
+    return values;
+}
+
+const char *baseName(int base)
+{
+    switch (base) {
+    case calc::BIN: return "bin";
+    case calc::OCT: return "oct";
+    case calc::HEX: return "hex";
+    default: return "dec";
+    }
+}
+
+// -------------------------------
+// 运行与输出
+// -------------------------------
+class Suite
+{
+public:
+    explicit Suite(const Options &options) : options(options) {}
+
+    bool enabled(const QString &name) const
+    {
+        return name.contains(QString::fromLocal8Bit(options.filter));
+    }
+
+    // 对 inputs 中的每一项反复调用 body，直到超过最短运行时间
+    // passChars 为遍历一次 inputs 处理的字符数，用于计算吞吐
+    template<typename T, typename Body>
+    void run(const QString &name, const QVector<T> &inputs, qint64 passChars, Body body)
+    {
+        lastRan = enabled(name) && !inputs.isEmpty();
+        if (!lastRan) return;
+
+        qint64 total = 0;
+        // 预热，同时让可复用的缓冲区先分配好；两轮才覆盖从最后一项回到第一项（有状态的用例如实时预览）
+        for (int pass = 0; pass < 2; ++pass) {
+            for (const T &input : inputs) total += body(input);
+        }
+
+        QElapsedTimer timer;
+        qint64 calls = 0;
+        qint64 passes = 0;
+        const quint64 allocationsBefore = bench::allocationCount();
+        timer.start();
+        do {
+            for (const T &input : inputs) total += body(input);
+            calls += inputs.size();
+            ++passes;
+        } while (timer.nsecsElapsed() < options.minDurationNs);
+        const qint64 elapsed = timer.nsecsElapsed();
+        const quint64 allocations = bench::allocationCount() - allocationsBefore;
+        sink = total;
+
+        Result result;
+        result.name = name;
+        result.ops = calls;
+        result.nsPerOp = double(elapsed) / double(calls);
+        result.opsPerSec = double(calls) * 1e9 / double(elapsed);
+        result.bytesPerSec = double(passChars) * double(passes) * 1e9 / double(elapsed);
+        result.allocsPerOp = double(allocations) / double(calls);
+        results.append(result);
+
+        if (options.format == TextOutput) {
+            printf("%-40s %10.1f ns/op %10.2f Mop/s", qPrintable(name), result.nsPerOp, result.opsPerSec / 1e6);
+            if (passChars > 0) printf(" %9.1f MB/s", result.bytesPerSec / 1e6);
+            else printf(" %9s     ", "");
+            printf(" %8.2f alloc/op\n", result.allocsPerOp);
+        }
+    }
+
+    // 文本模式下报告刚运行的两个用例（"<组>/legacy" 与同组的新实现）的加速比
+    void speedup()
+    {
+        if (options.format != TextOutput || !lastRan || results.size() < 2) return;
+        const Result &legacy = results[results.size() - 2];
+        const Result &current = results.last();
+        const QString suffix = QStringLiteral("/legacy");
+        if (!legacy.name.endsWith(suffix)) return;
+        const QString group = legacy.name.left(legacy.name.size() - suffix.size());
+        if (!current.name.startsWith(group)) return;
+        printf("%-40s %10.2fx\n", "  speedup", legacy.nsPerOp / current.nsPerOp);
+    }
+
+    // 刚运行的用例（预热后）每次调用的分配次数不应超过 budget：超出时输出到 stderr 并计数
+    void expectAllocationsAtMost(double budget)
+    {
+        if (!lastRan || results.last().allocsPerOp <= budget) return;
+        ++allocationFailures;
+        fprintf(stderr, "bench: %s 应当不超过 %.2f alloc/op，实际 %.2f alloc/op\n",
+                qPrintable(results.last().name), budget, results.last().allocsPerOp);
+    }
+
+    void expectNoAllocations() { expectAllocationsAtMost(0); }
+
+    int allocationFailureCount() const { return allocationFailures; }
+
+    void finish() const
+    {
+        if (options.format == CsvOutput) printCsv();
+        else if (options.format == JsonOutput) printJson();
+    }
+
+private:
+    void printCsv() const
+    {
+        printf("name,ops,ns_per_op,ops_per_sec,bytes_per_sec,allocs_per_op\n");
+        for (const Result &r : results) {
+            printf("\"%s\",%lld,%.3f,%.1f,%.1f,%.4f\n", qPrintable(r.name), r.ops,
+                   r.nsPerOp, r.opsPerSec, r.bytesPerSec, r.allocsPerOp);
+        }
+    }
+
+    void printJson() const
+    {
+        printf("{\n");
+        printf("  \"bitfield_kernel\": \"%s\",\n", calc::bitFieldKernelName());
+        printf("  \"column_kernel\": \"%s\",\n", calc::columnKernelName());
+        printf("  \"counts_malloc\": %s,\n", bench::countsMalloc() ? "true" : "false");
+        printf("  \"benchmarks\": [\n");
+        for (int i = 0; i < results.size(); ++i) {
+            const Result &r = results[i];
+            printf("    {\"name\": \"%s\", \"ops\": %lld, \"ns_per_op\": %.3f, \"ops_per_sec\": %.1f, "
+                   "\"bytes_per_sec\": %.1f, \"allocs_per_op\": %.4f}%s\n",
+                   qPrintable(r.name), r.ops, r.nsPerOp, r.opsPerSec, r.bytesPerSec, r.allocsPerOp,
+                   i + 1 < results.size() ? "," : "");
+        }
+        printf("  ]\n}\n");
+    }
+
+    const Options &options;
+    QVector<Result> results;
+    bool lastRan = false;  // 最近一次 run 是否实际运行
+    int allocationFailures = 0;
+};
+
+// 一组字符串的总字符数
+qint64 totalChars(const QStringList &texts)
+{
+    qint64 chars = 0;
+    for (const QString &text : texts) chars += text.size();
+    return chars;
+}
+
+// 由 64 位样本派生的 Bits 位数值：依次填入 0 到全部高位块，覆盖短数、满位宽的正数和负数
+template<int Bits>
+QVector<calc::WideInt<Bits>> makeWideValues(const QVector<qint64> &values)
+{
+    QVector<calc::WideInt<Bits>> wide;
+    wide.reserve(values.size());
+    for (int i = 0; i < values.size(); ++i) {
+        calc::WideInt<Bits> value = calc::WideInt<Bits>::fromInt64(values[i]);
+        const int filled = i % calc::WideInt<Bits>::Limbs;
+        for (int j = 1; j <= filled; ++j) {
+            value.limb[j] = quint64(values[(i + j) % values.size()]) * Q_UINT64_C(0x9E3779B97F4A7C15);
+        }
+        wide.append(value);
+    }
+    return wide;
+}
+
+// 宽整数：进制格式化（十进制为分治转换）、解析、求值和整个显示刷新
+template<int Bits>
+void runWide(Suite &suite, const QVector<qint64> &values, const QVector<Expression> &expressions,
+             const QStringList &rules)
+{
+    typedef calc::WideInt<Bits> Value;
+    const QVector<Value> wide = makeWideValues<Bits>(values);
+    const QString prefix = QStringLiteral("wide%1/").arg(Bits);
+    QChar buffer[calc::maxNumberChars(Bits)];
+
+    suite.run(prefix + QStringLiteral("dec"), wide, 0, [&](const Value &v) {
+        return qint64(calc::formatNumber(buffer, v, calc::DEC));
+    });
+    suite.run(prefix + QStringLiteral("hex"), wide, 0, [&](const Value &v) {
+        return qint64(calc::formatNumber(buffer, v, calc::HEX));
+    });
+
+    QStringList texts;
+    for (const Value &v : wide) texts << QString(buffer, calc::formatNumber(buffer, v, calc::DEC));
+    suite.run(prefix + QStringLiteral("parse/dec"), texts.toVector(), totalChars(texts), [](const QString &text) {
+        return qint64(calc::parseNumber<Bits>(QStringView(text), calc::DEC).value.low64());
+    });
+
+    QVector<calc::Program> programs;
+    for (const Expression &e : expressions) {
+        if (!calc::validate(QStringView(e.text), e.base).ok()) continue;
+        calc::Program program = calc::compile(e.text, e.base, Bits);
+        if (program.ok()) programs.append(program);
+    }
+    const Value x = Value::fromInt64(12345);
+    suite.run(prefix + QStringLiteral("evaluate/execute"), programs, 0, [&x](const calc::Program &p) {
+        return qint64(calc::execute(p, x).low64());
+    });
+    suite.expectNoAllocations();
+
+    // 另加每 4 位一段的规则（Bits / 4 段），对照整体刷新与结果框逐段编辑时只格式化改动的一段
+    QString dense = QStringLiteral("4");
+    for (int i = 1; i < Bits / 4; ++i) dense += QStringLiteral(",4");
+    QStringList displayRules = rules;
+    displayRules << dense;
+
+    calc::DisplayStrings out;
+    for (const QString &rule : displayRules) {
+        const calc::SplitLayout layout{QStringView(rule)};
+        const QString tag = rule == dense ? QStringLiteral("[4x%1]").arg(Bits / 4)
+                                          : QLatin1Char('[') + rule + QLatin1Char(']');
+        suite.run(prefix + QStringLiteral("display") + tag, wide, 0, [&](const Value &v) {
+            calc::formatDisplay(v, layout, out);
+            return qint64(out.hexSplit.size());
+        });
+        suite.run(prefix + QStringLiteral("display/field") + tag, wide, 0, [&](const Value &v) {
+            calc::formatValues(v, out);
+            const int valueBits = v.bitLength();
+            const calc::SplitField field = layout.field(layout.fieldCount(valueBits) / 2, valueBits);
+            return qint64(calc::formatSplitField(v, field, calc::BIN).size()
+                          + calc::formatSplitField(v, field, calc::DEC).size()
+                          + calc::formatSplitField(v, field, calc::HEX).size());
+        });
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage(stderr);
+        return 2;
+    }
+
+    QVector<Expression> expressions;
+    QStringList rules;
+    const QString expressionPath = options.corpusDir + QStringLiteral("/expressions.txt");
+    const QString rulePath = options.corpusDir + QStringLiteral("/split_rules.txt");
+    if (!loadExpressions(expressionPath, expressions)) {
+        fprintf(stderr, "bench: 无法读取语料: %s\n", qPrintable(expressionPath));
+        return 2;
+    }
+    if (!loadSplitRules(rulePath, rules)) {
+        fprintf(stderr, "bench: 无法读取语料: %s\n", qPrintable(rulePath));
+        return 2;
+    }
+
+    Suite suite(options);
+    const QVector<qint64> values = makeValues();
+    QChar buffer[calc::MaxNumberChars];
+
+    // 表达式：校验、编译、缓存编译后求值、求值缓存（界面的 evaluateExpression）、直接执行字节码、C 接口、实时预览
+    // 除了每次新建程序的 compile，都应当不分配内存
+    {
+        qint64 chars = 0;
+        QVector<Expression> valid;
+        QVector<calc::Program> programs;
+        for (const Expression &e : expressions) {
+            chars += e.text.size();
+            if (!calc::validate(QStringView(e.text), e.base).ok()) continue;
+            calc::Program program = calc::compile(e.text, e.base);
+            if (!program.ok()) continue;
+            valid.append(e);
+            programs.append(program);
+        }
+        qint64 validChars = 0;
+        for (const Expression &e : valid) validChars += e.text.size();
+
+        suite.run(QStringLiteral("validate"), expressions, chars, [](const Expression &e) {
+            return qint64(calc::validate(QStringView(e.text), e.base).column);
+        });
+        suite.expectNoAllocations();
+        suite.run(QStringLiteral("compile"), valid, validChars, [](const Expression &e) {
+            return qint64(calc::compile(e.text, e.base).code.size());
+        });
+        calc::Program reused;
+        suite.run(QStringLiteral("compile/reuse"), valid, validChars, [&reused](const Expression &e) {
+            calc::compile(QStringView(e.text), e.base, 64, reused);
+            return qint64(reused.code.size());
+        });
+        suite.expectNoAllocations();
+        calc::ProgramCache cache;
+        suite.run(QStringLiteral("evaluate/cached"), valid, validChars, [&](const Expression &e) {
+            return calc::execute(cache.get(e.text, e.base), 12345);
+        });
+        suite.expectNoAllocations();
+        // 语料含非法表达式，与界面一样连同校验结果一起缓存；容量足够时除第一轮外全部命中
+        calc::EvaluationCache memo(128);
+        const calc::WideValue x = calc::WideValue::fromInt64(12345);
+        suite.run(QStringLiteral("evaluate/memo"), expressions, chars, [&](const Expression &e) {
+            return qint64(memo.evaluate(QStringView(e.text), e.base, 64, x).value.low64());
+        });
+        suite.expectNoAllocations();
+        // 未命中（界面对新表达式按"="）：容量为 1 时每次都换一个表达式，必然未命中；
+        // 淘汰的项连同键和程序数组一起复用，预热后同样不分配
+        calc::EvaluationCache missing(1);
+        suite.run(QStringLiteral("evaluate/memo/miss"), expressions, chars, [&](const Expression &e) {
+            return qint64(missing.evaluate(QStringView(e.text), e.base, 64, x).value.low64());
+        });
+        suite.expectNoAllocations();
+        suite.run(QStringLiteral("evaluate/execute"), programs, 0, [](const calc::Program &p) {
+            return calc::execute(p, 12345);
+        });
+        suite.expectNoAllocations();
+        // C 接口一次完成校验、编译和执行（含非法表达式）
+        QVector<QPair<QByteArray, int>> latin1;
+        for (const Expression &e : expressions) latin1.append(qMakePair(e.text.toLatin1(), e.base));
+        suite.run(QStringLiteral("evaluate/capi"), latin1, chars, [](const QPair<QByteArray, int> &e) {
+            int64_t result = 0;
+            calc_evaluate(e.first.constData(), size_t(e.first.size()), e.second, 12345, &result, nullptr);
+            return qint64(result);
+        });
+        suite.expectNoAllocations();
+
+        // 实时预览：粘贴的长表达式（语料中合法的十六进制表达式各加括号后相加），
+        // 每次按键在某个括号组内插入或删除一位数字，完整重新求值与增量求值对比
+        QString pasted;
+        for (int i = 0; pasted.size() < 4000; i = (i + 1) % valid.size()) {
+            if (valid[i].base != calc::HEX) continue;
+            if (!pasted.isEmpty()) pasted += QLatin1Char('+');
+            pasted += QLatin1Char('(') + valid[i].text + QLatin1Char(')');
+        }
+        QVector<QString> keystrokes;
+        QString typed = pasted;
+        for (int i = 0; i < 64; ++i) {
+            const int at = typed.indexOf(QLatin1Char('('), typed.size() * (i / 2) / 32) + 1;
+            if (i % 2 == 0) typed.insert(at, QLatin1Char('1'));
+            else typed.remove(at, 1);
+            keystrokes.append(typed);
+        }
+        const qint64 keystrokeChars = qint64(pasted.size()) * keystrokes.size();
+        suite.run(QStringLiteral("preview/full"), keystrokes, keystrokeChars, [&](const QString &text) {
+            if (!calc::validate(QStringView(text), calc::HEX).ok()) return qint64(0);
+            calc::compile(QStringView(text), calc::HEX, 64, reused);
+            return calc::execute(reused, 12345);
+        });
+        suite.expectNoAllocations();
+        calc::LiveExpression live;
+        suite.run(QStringLiteral("preview/live"), keystrokes, keystrokeChars, [&](const QString &text) {
+            live.setText(QStringView(text), calc::HEX);
+            return qint64(live.evaluate(64, x).value.low64());
+        });
+        suite.expectNoAllocations();
+    }
+
+    // 单个数值的进制格式化
+    suite.run(QStringLiteral("dec/legacy"), values, 0, [](qint64 v) { return qint64(QString::number(v, 10).size()); });
+    suite.run(QStringLiteral("dec/lut"), values, 0, [&](qint64 v) { return qint64(calc::formatNumber(buffer, v, calc::DEC)); });
+    suite.speedup();
+    suite.run(QStringLiteral("hex/legacy"), values, 0, [](qint64 v) {
+        return qint64(QString::number(v, 16).toUpper().size());
+    });
+    suite.run(QStringLiteral("hex/lut"), values, 0, [&](qint64 v) { return qint64(calc::formatNumber(buffer, v, calc::HEX)); });
+    suite.speedup();
+
+    // 二进制分组：输入为不带空格的二进制文本
+    {
+        QStringList bins;
+        for (qint64 v : values) bins << QString::number(v, 2);
+        const QVector<QString> inputs = bins.toVector();
+        const qint64 chars = totalChars(bins);
+        suite.run(QStringLiteral("binSpaces/legacy"), inputs, chars, [](const QString &bin) {
+            return qint64(legacy::formatBinWithSpaces(bin).size());
+        });
+        suite.run(QStringLiteral("binSpaces"), inputs, chars, [](const QString &bin) {
+            return qint64(calc::formatBinWithSpaces(bin).size());
+        });
+        suite.speedup();
+        suite.run(QStringLiteral("binSpaces/lut"), values, 0, [&](qint64 v) {
+            return qint64(calc::formatBinField(buffer, quint64(v), calc::bitLength(quint64(v)), true));
+        });
+    }
+
+    // 输入框解析：旧的 checkValueOverflow + toLongLong 与一遍扫描的 parseNumber
+    const int bases[] = { calc::BIN, calc::OCT, calc::DEC, calc::HEX };
+    for (int base : bases) {
+        QStringList texts;
+        for (qint64 v : values) texts << QString(buffer, calc::formatNumber(buffer, v, base));
+        const QVector<QString> inputs = texts.toVector();
+        const qint64 chars = totalChars(texts);
+        const QString name = QStringLiteral("parse/") + QLatin1String(baseName(base));
+        suite.run(name + QStringLiteral("/legacy"), inputs, chars, [base](const QString &text) {
+            long long value = 0;
+            return legacy::parseInput(text, base, value) ? qint64(value) : 0;
+        });
+        suite.run(name, inputs, chars, [base](const QString &text) {
+            return qint64(calc::parseNumber(QStringView(text), base).value);
+        });
+        suite.speedup();
+    }
+
+    runWide<128>(suite, values, expressions, rules);
+    runWide<256>(suite, values, expressions, rules);
+    runWide<512>(suite, values, expressions, rules);
+
+    // 按分割规则：二进制分割、结果框回写（updateFromResultValue）、整个显示刷新
+    for (const QString &rule : rules) {
+        const calc::SplitLayout layout{QStringView(rule)};
+        const QString tag = QLatin1Char('[') + rule + QLatin1Char(']');
+
+        suite.run(QStringLiteral("binSplit") + tag + QStringLiteral("/legacy"), values, 0, [&rule](qint64 v) {
+            return qint64(legacy::formatBinWithSplit(QString::number(v, 2), rule).size());
+        });
+        suite.run(QStringLiteral("binSplit") + tag, values, 0, [&layout](qint64 v) {
+            return qint64(calc::formatBinWithSplit(quint64(v), layout).size());
+        });
+        suite.speedup();
+
+        if (!layout.isEmpty()) {
+            // 结果框的文本：二进制分割串和各段十进制 / 十六进制
+            const int resultBases[] = { calc::BIN, calc::DEC, calc::HEX };
+            for (int base : resultBases) {
+                QStringList texts;
+                QVector<QPair<QString, int>> inputs;
+                for (qint64 v : values) {
+                    const quint64 bits = quint64(v);
+                    const QString text = base == calc::BIN
+                            ? calc::formatBinWithSplit(bits, layout)
+                            : calc::convertSplitParts(bits, layout, base).join(QLatin1Char('|'));
+                    texts << text;
+                    inputs.append(qMakePair(text, calc::bitLength(bits)));
+                }
+                const QString name = QStringLiteral("reassemble") + tag + QLatin1Char('/') + QLatin1String(baseName(base));
+                suite.run(name, inputs, totalChars(texts), [&layout, base](const QPair<QString, int> &input) {
+                    quint64 value = 0;
+                    calc::parseSplitParts(QStringView(input.first), layout, input.second, base, value);
+                    return qint64(value);
+                });
+            }
+        }
+
+        legacy::DisplayStrings legacyOut;
+        calc::DisplayStrings out;
+        suite.run(QStringLiteral("display") + tag + QStringLiteral("/legacy"), values, 0, [&](qint64 v) {
+            legacy::formatDisplay(v, rule, legacyOut);
+            return qint64(legacyOut.hexSplit.size());
+        });
+        suite.run(QStringLiteral("display") + tag, values, 0, [&](qint64 v) {
+            calc::formatDisplay(v, layout, out);
+            return qint64(out.hexSplit.size());
+        });
+        suite.speedup();
+    }
+
+    suite.finish();
+    if (options.checkAllocations && suite.allocationFailureCount() > 0) return 1;
+    return 0;
+}
@@ -2,7 +2,10 @@
 #include "ui_mainwindow.h"
 
 #include <QPushButton>
-#include <QMessageBox>
+#include <QTimer>
+
+#include "radix.h"
+#include "trace.h"
 
 // -------------------------------
 // 按钮槽函数
@@ -218,36 +221,27 @@ void MainWindow::onBackspaceClicked()
 
 void MainWindow::onEqualClicked()
 {
+    TRACE_SCOPE("onEqualClicked");
     QString expr = ui->editExpression->text();
     if(expr.isEmpty()) return;
     
-    // 检查表达式是否合法
-    QString errorMsg;
-    if (!validateExpression(expr, currentBase, errorMsg)) {
-        QMessageBox::warning(this, "表达式错误", errorMsg);
-        return;
-    }
-    
-    try {
-        // 假设 evaluateExpression 返回 long long
-        long long result = evaluateExpression(expr, currentBase);
-
-        // 更新所有显示框
-        updateAllDisplays(result);
-
-        // 显式触发一次分割刷新
-        QString rawBin = ui->editBin->text();
-        rawBin.remove(' '); // 移除空格
-        ui->editBinResult->setText(formatBinWithSplit(rawBin, ui->editSplitRule->text()));
-    } catch (...) {
-        QMessageBox::warning(this, "Error", "表达式错误");
-    }
+    // 在工作线程中检查表达式是否合法并计算，变量 x 取当前显示的数值；
+    // 结果由 onExpressionEvaluated 更新显示，错误显示在状态提示中，不弹出对话框
+    const calc::WideValue x = display.valid ? display.value : calc::WideValue();
+    evaluator->submit(ExpressionEvaluator::Commit, expr, currentBase, display.valueBits, x);
+    commitPending = true;
+    busyTimer->start();
 }
 
 void MainWindow::onClearClicked()
 {
     isUpdating = true;
 
+    // 清空显示模型，丢弃尚未刷新的更新和尚未回来的求值结果
+    display.valid = false;
+    display.dirty = 0;
+    cancelCommit();
+
     // 清空所有输入框
     ui->editExpression->clear();
     ui->editHex->clear();
@@ -274,19 +268,13 @@ void MainWindow::onResetClicked()
 {
     isUpdating = true;
 
-    // 将除划分规则外的所有输入框置零
-    ui->editExpression->setText("0");
-    ui->editHex->setText("0");
-    ui->editDec->setText("0");
-    ui->editOct->setText("0");
-    ui->editBin->setText("0");
-    ui->editBinResult->setText("0");
-    ui->editDecResult->setText("0");
-    ui->editHexResult->setText("0");
-    // 注意：editSplitRule 不清空，保持原样
+    // 尚未回来的"="结果不再覆盖置零后的数值
+    cancelCommit();
 
-    // 更新所有显示
-    updateAllDisplays(0);
+    // 将除划分规则外的所有输入框置零：表达式直接写入，其余由显示模型统一刷新
+    // 注意：editSplitRule 不清空，保持原样
+    ui->editExpression->setText("0");
+    updateAllDisplays(calc::WideValue());
 
     // 重置最后获得焦点的输入框为表达式框
     lastFocusedEdit = ui->editExpression;
@@ -1,35 +1,29 @@
-QT       += core gui qml widgets
-
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
-
-CONFIG += c++11
-
-# You can make your code fail to compile if it uses deprecated APIs.
-# In order to do so, uncomment the following line.
-#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
-
-SOURCES += \
-    main.cpp \
-    buttons.cpp \
-    input.cpp \
-    mainwindow.cpp \
-    result.cpp \
-    display.cpp \
-    expression.cpp \
-    update.cpp
-
-HEADERS += \
-    mainwindow.h
-
-FORMS += \
-    mainwindow.ui
-
-TRANSLATIONS += \
-    cal_zh_CN.ts
-CONFIG += lrelease
-CONFIG += embed_translations
-
-# Default rules for deployment.
-qnx: target.path = /tmp/$${TARGET}/bin
-else: unix:!android: target.path = /opt/$${TARGET}/bin
-!isEmpty(target.path): INSTALLS += target
+TEMPLATE = subdirs
+
+# 计算引擎静态库（只依赖 QtCore，带 C 接口）
+SUBDIRS += engine
+engine.file = engine/engine.pro
+
+# 图形界面计算器
+SUBDIRS += app
+app.file = app.pro
+app.depends = engine
+
+# 命令行批量计算工具（不依赖 QtWidgets）
+SUBDIRS += cli
+cli.file = cli/calc-cli.pro
+cli.depends = engine
+
+# 格式化与求值路径的微基准
+SUBDIRS += bench
+bench.file = bench/bench.pro
+bench.depends = engine
+
+# 本地套接字求值服务及其测试客户端 / 压力生成器（QtNetwork）
+SUBDIRS += server
+server.file = server/calc-server.pro
+server.depends = engine
+
+SUBDIRS += client
+client.file = client/calc-client.pro
+client.depends = engine
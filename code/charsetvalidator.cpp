@@ -0,0 +1,24 @@
+#include "charsetvalidator.h"
+
+CharSetValidator::CharSetValidator(const char *chars, int options, QObject *parent)
+    : QValidator(parent)
+    , options(options)
+{
+    for (const char *p = chars; *p; ++p) {
+        const uint c = uchar(*p);
+        if (c < 128) allowed[c >> 6] |= quint64(1) << (c & 63);
+    }
+}
+
+QValidator::State CharSetValidator::validate(QString &input, int &pos) const
+{
+    Q_UNUSED(pos);
+    for (int i = 0; i < input.size(); ++i) {
+        const ushort c = input.at(i).unicode();
+        if (c < 128 && (allowed[c >> 6] >> (c & 63)) & 1) continue;
+        if (i == 0 && c == '-' && (options & LeadingMinus)) continue;
+        if ((options & AllowSpace) && (c == ' ' || (c >= '\t' && c <= '\r'))) continue;
+        return Invalid;
+    }
+    return Acceptable;
+}
@@ -0,0 +1,29 @@
+#ifndef CHARSETVALIDATOR_H
+#define CHARSETVALIDATOR_H
+
+#include <QValidator>
+
+// -------------------------------
+// 按字符集逐字符检查的输入校验，替代只含字符类的 QRegularExpressionValidator
+// 构造时只填一张 ASCII 位表，不编译正则，窗口启动时创建九个也几乎没有开销
+// -------------------------------
+class CharSetValidator : public QValidator
+{
+public:
+    enum Option {
+        NoOption     = 0,
+        AllowSpace   = 1 << 0,  // 允许 ASCII 空白（空格和 \t \n \v \f \r），与不带 Unicode 属性的正则 \s 一致
+        LeadingMinus = 1 << 1   // 允许开头一个负号
+    };
+
+    // chars 为允许的 ASCII 字符
+    CharSetValidator(const char *chars, int options, QObject *parent = nullptr);
+
+    State validate(QString &input, int &pos) const override;
+
+private:
+    quint64 allowed[2] = { 0, 0 };  // 128 位，每个 ASCII 字符一位
+    int options;
+};
+
+#endif // CHARSETVALIDATOR_H
@@ -0,0 +1,26 @@
+QT = core
+
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+TARGET = calc-cli
+
+include(../engine/engine.pri)
+
+SOURCES += \
+    main.cpp \
+    columnar.cpp \
+    decode.cpp \
+    lineio.cpp \
+    scheduler.cpp
+
+HEADERS += \
+    columnar.h \
+    decode.h \
+    lineio.h \
+    scheduler.h
+
+# Default rules for deployment.
+qnx: target.path = /tmp/cal/bin
+else: unix:!android: target.path = /opt/cal/bin
+!isEmpty(target.path): INSTALLS += target
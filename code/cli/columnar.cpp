@@ -0,0 +1,499 @@
+#include "columnar.h"
+
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "base.h"
+#include "lineio.h"
+#include "radix.h"
+
+namespace {
+
+const char Magic[8] = {'C', 'A', 'L', 'C', 'C', 'O', 'L', 'S'};
+const quint32 Version = 1;
+const int HeaderBytes = 32;      // 魔数、版本、列数、行数、规则长度
+const int DirectoryBytes = 32;   // 每列：位宽、偏移、掩码、起点、字节数
+const int BlockHeaderBytes = 16; // 值个数、条目数、编码、打包位宽、参考值
+const int CopyBlockBytes = 1 << 20; // 写出时从临时文件拷贝列数据的块大小
+
+inline quint64 lowMask(int bits)
+{
+    return bits >= 64 ? ~quint64(0) : (quint64(1) << bits) - 1;
+}
+
+inline int bitLength(quint64 value)
+{
+    return value ? 64 - __builtin_clzll(value) : 0;
+}
+
+inline qsizetype packedBytes(qsizetype count, int bits)
+{
+    return (count * bits + 63) / 64 * 8;
+}
+
+inline qsizetype align8(qsizetype size)
+{
+    return (size + 7) & ~qsizetype(7);
+}
+
+// 各值（已截到 bits 位）从低位起依次紧密排列，按小端 64 位字写出，返回写入的字节数
+qsizetype packBits(const quint64 *values, qsizetype count, int bits, char *out)
+{
+    if (bits == 0) return 0;
+    char *p = out;
+    quint64 word = 0;
+    int filled = 0;
+    for (qsizetype i = 0; i < count; ++i) {
+        const quint64 value = values[i];
+        word |= value << filled;
+        filled += bits;
+        if (filled >= 64) {
+            qToLittleEndian(word, p);
+            p += 8;
+            filled -= 64;
+            word = filled ? value >> (bits - filled) : 0;
+        }
+    }
+    if (filled) {
+        qToLittleEndian(word, p);
+        p += 8;
+    }
+    return p - out;
+}
+
+void unpackBits(const uchar *in, qsizetype count, int bits, quint64 *out)
+{
+    if (bits == 0) {
+        std::fill(out, out + count, quint64(0));
+        return;
+    }
+    const quint64 mask = lowMask(bits);
+    qsizetype pos = 0;
+    for (qsizetype i = 0; i < count; ++i, pos += bits) {
+        const uchar *word = in + (pos >> 6) * 8;
+        const int offset = int(pos & 63);
+        quint64 value = qFromLittleEndian<quint64>(word) >> offset;
+        if (offset + bits > 64) value |= qFromLittleEndian<quint64>(word + 8) << (64 - offset);
+        out[i] = value & mask;
+    }
+}
+
+// 按段宽回绕的差值先符号扩展，再 zigzag 成无符号数，仍不超过段宽
+inline quint64 zigzag(quint64 delta, int width)
+{
+    const qint64 value = width >= 64 ? qint64(delta) : qint64(delta << (64 - width)) >> (64 - width);
+    return (quint64(value) << 1) ^ quint64(value >> 63);
+}
+
+inline quint64 unzigzag(quint64 value)
+{
+    return (value >> 1) ^ (quint64(0) - (value & 1));
+}
+
+void writeBlockHeader(char *out, int count, int items, ColumnEncoding encoding, int bits, quint64 reference)
+{
+    qToLittleEndian(quint16(count), out);
+    qToLittleEndian(quint16(items), out + 2);
+    out[4] = char(encoding);
+    out[5] = char(bits);
+    out[6] = out[7] = 0;
+    qToLittleEndian(reference, out + 8);
+}
+
+// 编码一块（count 不超过 ColumnBlockValues）：在 plain 和允许的编码中取最小的一种，不会比 plain 大
+qsizetype packBlock(const quint64 *values, int count, int width, ColumnEncoding encoding, char *out)
+{
+    const quint64 mask = lowMask(width);
+    quint64 deltas[ColumnBlockValues];
+    quint64 runValues[ColumnBlockValues];
+    quint64 runLengths[ColumnBlockValues];
+    int deltaBits = 0;
+    int lengthBits = 0;
+    int runs = 0;
+
+    if (encoding == DeltaEncoding || encoding == AutoEncoding) {
+        quint64 bits = 0;
+        for (int i = 1; i < count; ++i) {
+            deltas[i - 1] = zigzag((values[i] - values[i - 1]) & mask, width);
+            bits |= deltas[i - 1];
+        }
+        deltaBits = bitLength(bits);
+    }
+    if (encoding == RunLengthEncoding || encoding == AutoEncoding) {
+        quint64 bits = 0;
+        for (int i = 0; i < count; ++runs) {
+            int j = i + 1;
+            while (j < count && values[j] == values[i]) ++j;
+            runValues[runs] = values[i];
+            runLengths[runs] = quint64(j - i - 1);
+            bits |= runLengths[runs];
+            i = j;
+        }
+        lengthBits = bitLength(bits);
+    }
+
+    qsizetype smallest = packedBytes(count, width);
+    const ColumnEncoding allowed = encoding;
+    encoding = PlainEncoding;
+    if (allowed == DeltaEncoding || allowed == AutoEncoding) {
+        const qsizetype delta = packedBytes(count - 1, deltaBits);
+        if (delta < smallest) {
+            smallest = delta;
+            encoding = DeltaEncoding;
+        }
+    }
+    if (allowed == RunLengthEncoding || allowed == AutoEncoding) {
+        const qsizetype rle = packedBytes(runs, width) + packedBytes(runs, lengthBits);
+        if (rle < smallest) encoding = RunLengthEncoding;
+    }
+
+    char *p = out + BlockHeaderBytes;
+    switch (encoding) {
+    case DeltaEncoding:
+        writeBlockHeader(out, count, count - 1, DeltaEncoding, deltaBits, values[0]);
+        p += packBits(deltas, count - 1, deltaBits, p);
+        break;
+    case RunLengthEncoding:
+        writeBlockHeader(out, count, runs, RunLengthEncoding, lengthBits, 0);
+        p += packBits(runValues, runs, width, p);
+        p += packBits(runLengths, runs, lengthBits, p);
+        break;
+    default:
+        writeBlockHeader(out, count, count, PlainEncoding, width, 0);
+        p += packBits(values, count, width, p);
+        break;
+    }
+    return p - out;
+}
+
+} // namespace
+
+bool parseColumnEncoding(const char *name, ColumnEncoding &encoding)
+{
+    if (!strcmp(name, "plain")) encoding = PlainEncoding;
+    else if (!strcmp(name, "delta")) encoding = DeltaEncoding;
+    else if (!strcmp(name, "rle")) encoding = RunLengthEncoding;
+    else if (!strcmp(name, "auto")) encoding = AutoEncoding;
+    else return false;
+    return true;
+}
+
+qsizetype maxPackedBytes(qsizetype count, int width)
+{
+    // 每块不超过 plain；各块的打包数据各自补齐到整字
+    const qsizetype blocks = (count + ColumnBlockValues - 1) / ColumnBlockValues;
+    return blocks * (BlockHeaderBytes + 8) + packedBytes(count, width);
+}
+
+qsizetype packColumn(const quint64 *values, qsizetype count, int width, ColumnEncoding encoding, char *out)
+{
+    char *p = out;
+    for (qsizetype i = 0; i < count; i += ColumnBlockValues) {
+        const int n = int(qMin<qsizetype>(ColumnBlockValues, count - i));
+        p += packBlock(values + i, n, width, encoding, p);
+    }
+    return p - out;
+}
+
+// -------------------------------
+// 写入
+// -------------------------------
+ColumnarWriter::ColumnarWriter(const QString &rule, ColumnEncoding encoding)
+    : rule(rule), columnEncoding(encoding)
+{
+    // 与转储解码一致，按 64 位整字应用规则；规则为空时整个数值为一列
+    const calc::SplitLayout layout(rule);
+    const int count = layout.fieldCount(64);
+    for (int i = 0; i < count; ++i) columnFields.append(layout.field(i, 64));
+}
+
+bool ColumnarWriter::open(const QString &output)
+{
+    path = output;
+    columns.clear();
+    columnSizes.fill(0, columnFields.size());
+    for (int i = 0; i < columnFields.size(); ++i) {
+        columns.emplace_back(new QTemporaryFile(path + QStringLiteral(".col%1.XXXXXX").arg(i)));
+        if (!columns.back()->open()) {
+            fprintf(stderr, "calc-cli: 无法在列式文件旁创建临时文件: %s\n", path.toLocal8Bit().constData());
+            return false;
+        }
+    }
+    return true;
+}
+
+void ColumnarWriter::append(int field, const char *data, qint64 size)
+{
+    if (failed) return;
+    if (columns[field]->write(data, size) != size) {
+        failed = true;
+        return;
+    }
+    columnSizes[field] += size;
+}
+
+bool ColumnarWriter::finish()
+{
+    const QByteArray ruleBytes = rule.toUtf8();
+    const qsizetype directory = HeaderBytes + align8(ruleBytes.size());
+    QByteArray header(int(directory + DirectoryBytes * columnFields.size()), '\0');
+    char *p = header.data();
+
+    memcpy(p, Magic, sizeof(Magic));
+    qToLittleEndian(Version, p + 8);
+    qToLittleEndian(quint32(columnFields.size()), p + 12);
+    qToLittleEndian(quint64(rows), p + 16);
+    qToLittleEndian(quint32(ruleBytes.size()), p + 24);
+    memcpy(p + HeaderBytes, ruleBytes.constData(), size_t(ruleBytes.size()));
+
+    quint64 offset = quint64(header.size());
+    for (int i = 0; i < columnFields.size(); ++i) {
+        char *entry = p + directory + DirectoryBytes * i;
+        qToLittleEndian(quint32(columnFields[i].width), entry);
+        qToLittleEndian(quint32(columnFields[i].shift), entry + 4);
+        qToLittleEndian(columnFields[i].bits, entry + 8);
+        qToLittleEndian(offset, entry + 16);
+        qToLittleEndian(quint64(columnSizes[i]), entry + 24);
+        offset += quint64(columnSizes[i]);
+    }
+
+    // 各列从临时文件按块拷贝到文件头之后
+    QFile file(path);
+    bool ok = !failed && file.open(QIODevice::WriteOnly | QIODevice::Truncate) && file.write(header) == header.size();
+    QByteArray buffer(CopyBlockBytes, Qt::Uninitialized);
+    for (size_t i = 0; ok && i < columns.size(); ++i) {
+        QTemporaryFile &column = *columns[i];
+        ok = column.seek(0);
+        for (qint64 left = columnSizes[int(i)]; ok && left > 0;) {
+            const qint64 n = column.read(buffer.data(), qMin<qint64>(left, buffer.size()));
+            ok = n > 0 && file.write(buffer.constData(), n) == n;
+            left -= n;
+        }
+    }
+    if (ok) ok = file.flush();
+    columns.clear();
+    if (!ok) {
+        fprintf(stderr, "calc-cli: 无法写出列式文件: %s\n", path.toLocal8Bit().constData());
+        if (file.isOpen()) file.remove();
+    }
+    return ok;
+}
+
+// -------------------------------
+// 读取
+// -------------------------------
+ColumnarFile::~ColumnarFile()
+{
+    if (data) file.unmap(const_cast<uchar *>(data));
+}
+
+bool ColumnarFile::open(const QString &path, QString &error)
+{
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = QStringLiteral("无法打开文件");
+        return false;
+    }
+    const qint64 size = file.size();
+    if (size < HeaderBytes) {
+        error = QStringLiteral("不是列式文件");
+        return false;
+    }
+    data = file.map(0, size);
+    if (!data) {
+        error = QStringLiteral("无法映射文件");
+        return false;
+    }
+    if (memcmp(data, Magic, sizeof(Magic)) != 0) {
+        error = QStringLiteral("不是列式文件");
+        return false;
+    }
+    if (qFromLittleEndian<quint32>(data + 8) != Version) {
+        error = QStringLiteral("不支持的列式文件版本");
+        return false;
+    }
+
+    const quint32 count = qFromLittleEndian<quint32>(data + 12);
+    const quint32 ruleBytes = qFromLittleEndian<quint32>(data + 24);
+    rows = qint64(qFromLittleEndian<quint64>(data + 16));
+    const qint64 directory = HeaderBytes + align8(ruleBytes);
+    // 每列至少 1 位，列数不超过 64
+    if (count == 0 || count > 64 || rows < 0 || directory + qint64(DirectoryBytes) * count > size) {
+        error = QStringLiteral("列式文件头已损坏");
+        return false;
+    }
+    splitRule = QString::fromUtf8(reinterpret_cast<const char *>(data + HeaderBytes), int(ruleBytes));
+
+    for (quint32 i = 0; i < count; ++i) {
+        const uchar *entry = data + directory + DirectoryBytes * i;
+        calc::SplitField field;
+        field.width = int(qFromLittleEndian<quint32>(entry));
+        field.shift = int(qFromLittleEndian<quint32>(entry + 4));
+        field.bits = qFromLittleEndian<quint64>(entry + 8);
+        Column column;
+        column.offset = qint64(qFromLittleEndian<quint64>(entry + 16));
+        column.size = qint64(qFromLittleEndian<quint64>(entry + 24));
+        if (field.width < 1 || field.width > 64 || column.offset < 0 || column.size < 0
+                || column.offset > size || column.size > size - column.offset) {
+            error = QStringLiteral("列式文件头已损坏");
+            return false;
+        }
+        fields.append(field);
+        columns.append(column);
+    }
+    return true;
+}
+
+ColumnarFile::Cursor::Cursor(const ColumnarFile &file, int index)
+    : pos(file.data + file.columns[index].offset),
+      end(pos + file.columns[index].size),
+      width(file.fields[index].width)
+{
+}
+
+int ColumnarFile::Cursor::next(quint64 *out)
+{
+    if (error || pos == end) return 0;
+    if (end - pos < BlockHeaderBytes) {
+        error = true;
+        return 0;
+    }
+
+    const int count = qFromLittleEndian<quint16>(pos);
+    const int items = qFromLittleEndian<quint16>(pos + 2);
+    const int encoding = pos[4];
+    const int bits = pos[5];
+    const quint64 reference = qFromLittleEndian<quint64>(pos + 8);
+    const uchar *payload = pos + BlockHeaderBytes;
+
+    qsizetype bytes = -1;
+    if (count < 1 || count > ColumnBlockValues || bits > 64) bytes = -1;
+    else if (encoding == PlainEncoding && bits == width && items == count) bytes = packedBytes(count, width);
+    else if (encoding == DeltaEncoding && bits <= width && items == count - 1) bytes = packedBytes(items, bits);
+    else if (encoding == RunLengthEncoding && items >= 1 && items <= count)
+        bytes = packedBytes(items, width) + packedBytes(items, bits);
+    if (bytes < 0 || bytes > end - payload) {
+        error = true;
+        return 0;
+    }
+
+    if (encoding == PlainEncoding) {
+        unpackBits(payload, count, width, out);
+    } else if (encoding == DeltaEncoding) {
+        const quint64 mask = lowMask(width);
+        unpackBits(payload, items, bits, out + 1);
+        quint64 value = reference & mask;
+        out[0] = value;
+        for (int i = 1; i < count; ++i) {
+            value = (value + unzigzag(out[i])) & mask;
+            out[i] = value;
+        }
+    } else {
+        // 先解出各段的值和长度，再从后往前展开，out 可以同时用作暂存
+        quint64 runValues[ColumnBlockValues];
+        unpackBits(payload, items, width, runValues);
+        unpackBits(payload + packedBytes(items, width), items, bits, out);
+        qint64 total = 0;
+        for (int r = 0; r < items; ++r) total += qint64(out[r]) + 1;
+        if (total != count) {
+            error = true;
+            return 0;
+        }
+        int i = count;
+        for (int r = items - 1; r >= 0; --r) {
+            const int length = int(out[r]) + 1;
+            for (int k = 0; k < length; ++k) out[--i] = runValues[r];
+        }
+    }
+    pos = payload + bytes;
+    return count;
+}
+
+// -------------------------------
+// 扫描：各列的游标同步前进，每次解码一块
+// -------------------------------
+namespace {
+
+int printSummary(const ColumnarFile &file, FILE *out)
+{
+    fprintf(out, "规则: %s\n", file.rule().isEmpty() ? "（无，整个数值）" : file.rule().toUtf8().constData());
+    fprintf(out, "行数: %lld\n", static_cast<long long>(file.rowCount()));
+    fputs("列\t位宽\t位\t字节\t每值位数\n", out);
+    for (int i = 0; i < file.fieldCount(); ++i) {
+        const calc::SplitField field = file.field(i);
+        const qint64 bytes = file.columnBytes(i);
+        fprintf(out, "%d\t%d\t%d..%d\t%lld\t%.2f\n", i, field.width, field.shift + field.width - 1, field.shift,
+                static_cast<long long>(bytes), file.rowCount() ? bytes * 8.0 / file.rowCount() : 0.0);
+    }
+    return fflush(out) == 0 ? 0 : -1;
+}
+
+} // namespace
+
+int scanColumnar(const QString &path, const QList<int> &fields, const QList<int> &outputs, FILE *out)
+{
+    ColumnarFile file;
+    QString error;
+    if (!file.open(path, error)) {
+        fprintf(stderr, "calc-cli: %s: %s\n", path.toLocal8Bit().constData(), error.toLocal8Bit().constData());
+        return -1;
+    }
+    if (fields.isEmpty()) return printSummary(file, out);
+
+    for (int index : fields) {
+        if (index < 0 || index >= file.fieldCount()) {
+            fprintf(stderr, "calc-cli: 列号超出范围: %d（共 %d 列）\n", index, file.fieldCount());
+            return -1;
+        }
+    }
+
+    std::vector<ColumnarFile::Cursor> cursors;
+    QVector<int> widths;
+    for (int index : fields) {
+        cursors.emplace_back(file, index);
+        widths.append(file.field(index).width);
+    }
+    QVector<quint64> values(fields.size() * ColumnBlockValues);
+
+    OutputWriter writer(out);
+    char digits[calc::maxNumberChars(64)];
+    qint64 rows = 0;
+    bool ok = true;
+    for (;;) {
+        int count = -1;
+        for (int f = 0; f < widths.size() && ok; ++f) {
+            const int n = cursors[f].next(values.data() + f * ColumnBlockValues);
+            if (cursors[f].hasError() || (count >= 0 && n != count)) ok = false;
+            count = n;
+        }
+        if (!ok || count == 0) break;
+
+        for (int i = 0; i < count; ++i) {
+            for (int b = 0; b < outputs.size(); ++b) {
+                const int base = outputs[b];
+                if (b > 0) writer.write('\t');
+                for (int f = 0; f < widths.size(); ++f) {
+                    const quint64 part = values[f * ColumnBlockValues + i];
+                    if (f > 0) writer.write('|');
+                    if (base == calc::BIN) writer.write(digits, calc::formatBinField(digits, part, widths[f], false));
+                    else writer.write(digits, calc::formatUnsigned(digits, part, base));
+                }
+            }
+            writer.write('\n');
+        }
+        rows += count;
+    }
+
+    if (!ok || rows != file.rowCount()) {
+        fprintf(stderr, "calc-cli: %s: 列数据已损坏\n", path.toLocal8Bit().constData());
+        return -1;
+    }
+    if (!writer.flush()) {
+        fputs("calc-cli: 写出结果失败\n", stderr);
+        return -1;
+    }
+    return 0;
+}
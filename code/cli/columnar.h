@@ -0,0 +1,140 @@
+#ifndef COLUMNAR_H
+#define COLUMNAR_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QList>
+#include <QString>
+#include <QTemporaryFile>
+#include <QVector>
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "splitlayout.h"
+
+// -------------------------------
+// 分段列式文件：转储解码的结果按段各存一列，每列按段的实际位宽紧密打包（3 位的段每个值只占 3 位）
+// 文件头自描述：分割规则原文、行数和各列的位置、位宽、掩码；读取时只映射并扫描需要的列
+//
+// 布局（小端，各部分按 8 字节对齐）：
+//   文件头    "CALCCOLS"、版本、列数、行数、规则长度，随后是规则原文（UTF-8）
+//   列目录    每列：位宽、偏移、掩码、列数据在文件中的起点和字节数
+//   列数据    若干块，每块最多 ColumnBlockValues 个值：
+//             块头  值个数、条目数、编码、打包位宽、参考值
+//             plain 各值按段宽打包
+//             delta 参考值为首个值，其余各值与前一个值之差（按段宽回绕，zigzag）按打包位宽打包
+//             rle   各段的值按段宽打包，随后各段长度减一按打包位宽打包
+// 各列按相同的行数分块，第 n 块在所有列中对应相同的行
+// -------------------------------
+
+// 每块的值个数上限
+const int ColumnBlockValues = 4096;
+
+enum ColumnEncoding {
+    PlainEncoding,      // 按段宽打包
+    DeltaEncoding,      // 差值：递增的计数器、时间戳
+    RunLengthEncoding,  // 游程：很少变化的状态位、模式字段
+    AutoEncoding        // 每块取三者中最小的一种（只用于写入，不出现在文件中）
+};
+// 写入时选择 delta 或 rle 的块若不比 plain 小，仍按 plain 存放
+
+// 按名称（plain / delta / rle / auto）解析编码，无效时返回 false
+bool parseColumnEncoding(const char *name, ColumnEncoding &encoding);
+
+// count 个值编码后的最大字节数，用于预先分配输出缓冲区
+qsizetype maxPackedBytes(qsizetype count, int width);
+
+// 把 count 个 width 位的值按 ColumnBlockValues 分块编码写到 out，返回写入的字节数
+qsizetype packColumn(const quint64 *values, qsizetype count, int width, ColumnEncoding encoding, char *out);
+
+// -------------------------------
+// 列式文件的写入：各线程把编码好的块交给它，按块的顺序追加到各列，最后写出文件头并依次拼接各列
+// 各列一边解码一边写到输出文件旁的临时文件（同一文件系统，不占内存），内存中只有在途的块
+// -------------------------------
+class ColumnarWriter
+{
+public:
+    ColumnarWriter(const QString &rule, ColumnEncoding encoding);
+
+    const QVector<calc::SplitField> &fields() const { return columnFields; }
+    ColumnEncoding encoding() const { return columnEncoding; }
+
+    // 在 path 旁为各列创建临时文件，失败时输出原因并返回 false
+    bool open(const QString &path);
+
+    // 追加某一列的若干块；addRows 记录这一批的行数（各列相同，每批只计一次）
+    // 写临时文件失败后不再写入，hasError 返回 true
+    void append(int field, const char *data, qint64 size);
+    void addRows(qint64 count) { rows += count; }
+    bool hasError() const { return failed; }
+
+    // 写出文件头和各列到 open 时的 path，失败时输出原因、删除不完整的文件并返回 false
+    bool finish();
+
+private:
+    QString path;
+    QString rule;
+    ColumnEncoding columnEncoding;
+    QVector<calc::SplitField> columnFields;  // 从高位到低位
+    std::vector<std::unique_ptr<QTemporaryFile>> columns;
+    QVector<qint64> columnSizes;
+    qint64 rows = 0;
+    bool failed = false;
+};
+
+// -------------------------------
+// 列式文件的读取：映射整个文件，校验文件头；逐列按块解码，只访问该列所在的页
+// -------------------------------
+class ColumnarFile
+{
+public:
+    ColumnarFile() = default;
+    ~ColumnarFile();
+
+    // 打开并校验文件头，失败时在 error 中给出原因
+    bool open(const QString &path, QString &error);
+
+    QString rule() const { return splitRule; }
+    qint64 rowCount() const { return rows; }
+    int fieldCount() const { return fields.size(); }
+    calc::SplitField field(int index) const { return fields[index]; }
+    qint64 columnBytes(int index) const { return columns[index].size; }
+
+    // 顺序读取一列：每次解码一块到 out（至少 ColumnBlockValues 个元素），返回值个数，读完或出错时返回 0
+    class Cursor
+    {
+    public:
+        Cursor(const ColumnarFile &file, int index);
+
+        int next(quint64 *out);
+        bool hasError() const { return error; }
+
+    private:
+        const uchar *pos;
+        const uchar *end;
+        int width;
+        bool error = false;
+    };
+
+private:
+    struct Column
+    {
+        qint64 offset = 0;
+        qint64 size = 0;
+    };
+
+    QFile file;
+    const uchar *data = nullptr;
+    QString splitRule;
+    qint64 rows = 0;
+    QVector<calc::SplitField> fields;
+    QVector<Column> columns;
+};
+
+// 扫描列式文件中 fields 指定的列（按列号，0 为最高位的段），逐行按 outputs 的进制输出到 out
+// fields 为空时输出文件头和各列的大小；返回 0 表示成功，文件无效或写出失败时输出原因并返回 -1
+int scanColumnar(const QString &path, const QList<int> &fields, const QList<int> &outputs, FILE *out);
+
+#endif // COLUMNAR_H
@@ -0,0 +1,397 @@
+#include "decode.h"
+
+#include <QFile>
+#include <QThread>
+#include <QVector>
+#include <QtEndian>
+
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "base.h"
+#include "bitfield.h"
+#include "columnar.h"
+#include "radix.h"
+
+namespace {
+
+// 二进制转储每块输出文本的上限（约 8MB）：块内的数值个数按每行的最大长度换算
+const int ChunkTextBytes = 1 << 23;
+// 写列式文件时每块的数值个数，为列的分块大小的整数倍
+const int PackedChunkValues = 1 << 18;
+// 十六进制转储每块的字节数（延伸到下一个换行之后）；行长不定，输出缓冲区按实际需要增长，
+// 最坏（每行只有一位数字）时一块约 32K 行；线程常驻，块小只多一次入队，却能留在缓存中
+const qint64 HexChunkBytes = 1 << 16;
+// 写列式文件时十六进制转储每块的字节数：输出已打包，块大一些，各列的块才不会被切得零碎
+const qint64 PackedHexChunkBytes = 1 << 20;
+// 每个线程在途的块数：一块解码时另一块等待写出
+const int ChunksPerWorker = 2;
+
+const char InvalidLine[] = "error: 无效的数值\n";
+const int InvalidLineLength = int(sizeof(InvalidLine)) - 1;
+
+// 各段的位置和每行文本的最大长度，整个文件共用
+struct DecodePlan
+{
+    QVector<calc::SplitField> fields;  // 从高位到低位；规则为空时为空
+    QList<int> outputs;
+    int maxLineLength = 0;
+    qint64 chunkValues = 0;            // 二进制转储每块的数值个数
+    qint64 chunkBytes = HexChunkBytes; // 十六进制转储每块的字节数
+    ColumnarWriter *columns = nullptr; // 不为空时写列式文件，不输出文本
+};
+
+// 位宽为 width 的无符号段按 base 输出的最长字符数；十进制位数按 log10(2) ≈ 1233 / 4096 估计
+int fieldChars(int width, int base)
+{
+    switch (base) {
+    case calc::BIN: return width;
+    case calc::OCT: return (width + 2) / 3;
+    case calc::HEX: return (width + 3) / 4;
+    default:        return ((width * 1233) >> 12) + 1;
+    }
+}
+
+DecodePlan makePlan(const DecodeOptions &options)
+{
+    DecodePlan plan;
+    plan.outputs = options.outputs;
+    if (!options.layout.isEmpty()) {
+        const int count = options.layout.fieldCount(64);
+        for (int i = 0; i < count; ++i) plan.fields.append(options.layout.field(i, 64));
+    }
+
+    int length = plan.outputs.size();  // 制表符和换行
+    for (int base : plan.outputs) {
+        if (plan.fields.isEmpty()) {
+            length += fieldChars(64, base) + 1;  // 十进制负号
+            continue;
+        }
+        length += plan.fields.size() - 1;
+        for (const calc::SplitField &field : plan.fields) length += fieldChars(field.width, base);
+    }
+    plan.maxLineLength = qMax(length, InvalidLineLength);
+    plan.chunkValues = qBound(1 << 10, ChunkTextBytes / plan.maxLineLength, 1 << 18);
+    return plan;
+}
+
+// 列式文件：各列与写入器的列一致（规则为空时整个数值为一列）
+DecodePlan makePlan(ColumnarWriter &columns)
+{
+    DecodePlan plan;
+    plan.fields = columns.fields();
+    plan.chunkValues = PackedChunkValues;
+    plan.chunkBytes = PackedHexChunkBytes;
+    plan.columns = &columns;
+    return plan;
+}
+
+// -------------------------------
+// 一块数据的解码：取得数值列、逐段整列提取、逐行格式化
+// 线程池中的每个槽各用一个，缓冲区在各块之间复用
+// -------------------------------
+class ChunkDecoder
+{
+public:
+    const uchar *begin = nullptr;
+    const uchar *end = nullptr;
+    QByteArray text;    // 本块的输出
+    QVector<QByteArray> packed; // 写列式文件时本块各列编码后的块
+    qint64 rows = 0;
+    qint64 failures = 0;
+
+    void run(const DecodePlan &plan, DumpFormat format)
+    {
+        failures = 0;
+        const quint64 *values = format == RawDump ? rawValues() : hexValues();
+        const qsizetype count = valid.size();
+        if (plan.columns) {
+            pack(plan, values, count);
+            return;
+        }
+
+        // 各段一列：提取掩码可以不连续，BMI2 可用时一条 pext
+        columns.resize(plan.fields.size() * count);
+        for (int f = 0; f < plan.fields.size(); ++f) {
+            calc::extractColumn(values, columns.data() + f * count, count, plan.fields[f].bits);
+        }
+
+        // 二进制转储按最长的行预留，不会增长；十六进制转储的块按字节切分，行数不定，
+        // 先按上限预留，不够时加倍（resize 不释放容量，之后的块直接复用）
+        text.resize(int(qBound<qint64>(plan.maxLineLength, qint64(count) * plan.maxLineLength, ChunkTextBytes)));
+        char *out = text.data();
+        const char *limit = out + text.size();
+        for (qsizetype i = 0; i < count; ++i) {
+            if (limit - out < plan.maxLineLength) {
+                const int used = int(out - text.constData());
+                text.resize(qMax(2 * text.size(), used + plan.maxLineLength));
+                out = text.data() + used;
+                limit = text.constData() + text.size();
+            }
+            if (!valid[i]) {
+                memcpy(out, InvalidLine, InvalidLineLength);
+                out += InvalidLineLength;
+                ++failures;
+                continue;
+            }
+            for (int b = 0; b < plan.outputs.size(); ++b) {
+                const int base = plan.outputs[b];
+                if (b > 0) *out++ = '\t';
+                if (plan.fields.isEmpty()) {
+                    out += calc::formatNumber(out, qint64(values[i]), base);
+                    continue;
+                }
+                for (int f = 0; f < plan.fields.size(); ++f) {
+                    const quint64 part = columns[f * count + i];
+                    if (f > 0) *out++ = '|';
+                    if (base == calc::BIN) out += calc::formatBinField(out, part, plan.fields[f].width, false);
+                    else out += calc::formatUnsigned(out, part, base);
+                }
+            }
+            *out++ = '\n';
+        }
+        text.resize(int(out - text.constData()));
+    }
+
+private:
+    // 逐段整列提取后按段宽编码；无效的行不写入，只计数
+    void pack(const DecodePlan &plan, const quint64 *values, qsizetype count)
+    {
+        if (valid.contains(0)) {
+            qsizetype kept = 0;
+            for (qsizetype i = 0; i < count; ++i) {
+                if (valid[i]) scratch[kept++] = scratch[i];
+                else ++failures;
+            }
+            count = kept;
+            values = scratch.constData();
+        }
+        rows = count;
+
+        columns.resize(count);
+        packed.resize(plan.fields.size());
+        for (int f = 0; f < plan.fields.size(); ++f) {
+            const calc::SplitField &field = plan.fields[f];
+            calc::extractColumn(values, columns.data(), count, field.bits);
+            QByteArray &out = packed[f];
+            out.resize(int(maxPackedBytes(count, field.width)));
+            out.resize(int(packColumn(columns.constData(), count, field.width, plan.columns->encoding(), out.data())));
+        }
+    }
+
+    // 映射的内存按页对齐、块按 8 字节切分；小端机器上直接作为数值列，否则逐个转换
+    const quint64 *rawValues()
+    {
+        const qsizetype count = (end - begin) / 8;
+        valid.fill(1, count);
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        return reinterpret_cast<const quint64 *>(begin);
+#else
+        scratch.resize(count);
+        for (qsizetype i = 0; i < count; ++i) scratch[i] = qFromLittleEndian<quint64>(begin + 8 * i);
+        return scratch.constData();
+#endif
+    }
+
+    // 逐行解析，忽略首尾空白和 0x 前缀；无效的行记为 0 并在输出中报错
+    const quint64 *hexValues()
+    {
+        scratch.clear();
+        valid.clear();
+        const char *p = reinterpret_cast<const char *>(begin);
+        const char *const limit = reinterpret_cast<const char *>(end);
+        while (p < limit) {
+            const char *newline = static_cast<const char *>(memchr(p, '\n', limit - p));
+            const char *lineEnd = newline ? newline : limit;
+            const char *first = p;
+            const char *last = lineEnd;
+            p = newline ? newline + 1 : limit;
+
+            while (first < last && (*first == ' ' || *first == '\t')) ++first;
+            while (last > first && (last[-1] == ' ' || last[-1] == '\t' || last[-1] == '\r')) --last;
+            if (last - first > 2 && first[0] == '0' && (first[1] == 'x' || first[1] == 'X')) first += 2;
+
+            const calc::ParsedNumber parsed = calc::parseUnsigned(first, int(last - first), calc::HEX);
+            scratch.append(parsed.ok() ? parsed.value : 0);
+            valid.append(parsed.ok() ? 1 : 0);
+        }
+        return scratch.constData();
+    }
+
+    QVector<quint64> scratch;
+    QVector<quint64> columns;
+    QVector<char> valid;  // 各行是否为有效数值
+};
+
+// 从 pos 开始的一块的终点：二进制按整数个数值，文本按字节数延伸到下一个换行之后
+qint64 chunkEnd(const uchar *data, qint64 pos, qint64 size, DumpFormat format, const DecodePlan &plan)
+{
+    if (format == RawDump) return qMin(size, pos + plan.chunkValues * 8);
+    const qint64 end = pos + plan.chunkBytes;
+    if (end >= size) return size;
+    const void *newline = memchr(data + end, '\n', size_t(size - end));
+    return newline ? static_cast<const uchar *>(newline) - data + 1 : size;
+}
+
+// -------------------------------
+// 解码线程池：线程在整个文件期间常驻，从队列中按顺序取块；每块放在环形的槽里，
+// 主线程按序号等待并写出，写出后槽即可装入新的块，在途的块数（内存）因此有上限
+// -------------------------------
+class DecodePool
+{
+public:
+    DecodePool(int jobs, const DecodePlan &plan, DumpFormat format)
+        : plan(plan), format(format), slots(size_t(jobs * ChunksPerWorker)), done(slots.size(), 0)
+    {
+        for (int i = 0; i < jobs; ++i) threads.emplace_back(&DecodePool::work, this);
+    }
+
+    ~DecodePool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        workReady.notify_all();
+        for (std::thread &thread : threads) thread.join();
+    }
+
+    qint64 capacity() const { return qint64(slots.size()); }
+    ChunkDecoder &slot(qint64 seq) { return slots[size_t(seq % capacity())]; }
+
+    // 序号为 seq 的槽已装入一块，交给线程解码
+    void submit(qint64 seq)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(seq);
+        }
+        workReady.notify_one();
+    }
+
+    // 等待序号为 seq 的块解码完成
+    ChunkDecoder &wait(qint64 seq)
+    {
+        const size_t index = size_t(seq % capacity());
+        std::unique_lock<std::mutex> lock(mutex);
+        chunkDone.wait(lock, [this, index]() { return done[index] != 0; });
+        done[index] = 0;
+        return slots[index];
+    }
+
+private:
+    void work()
+    {
+        for (;;) {
+            qint64 seq;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                workReady.wait(lock, [this]() { return !queue.empty() || stopping; });
+                if (queue.empty()) return;
+                seq = queue.front();
+                queue.pop_front();
+            }
+            const size_t index = size_t(seq % capacity());
+            slots[index].run(plan, format);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                done[index] = 1;
+            }
+            chunkDone.notify_one();
+        }
+    }
+
+    const DecodePlan &plan;
+    const DumpFormat format;
+    std::vector<ChunkDecoder> slots;
+    std::vector<char> done;        // 各槽是否已解码完成，受 mutex 保护
+    std::vector<std::thread> threads;
+
+    std::mutex mutex;
+    std::condition_variable workReady;
+    std::condition_variable chunkDone;
+    std::deque<qint64> queue;      // 待解码的槽的序号
+    bool stopping = false;
+};
+
+// 文本输出到 out，或者（plan.columns 不为空时）追加到列式文件
+qint64 decodeFile(const QString &path, FILE *out, const DecodeOptions &options, const DecodePlan &plan)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "calc-cli: 无法打开文件: %s\n", path.toLocal8Bit().constData());
+        return -1;
+    }
+    qint64 size = file.size();
+    if (size == 0) return 0;
+    const uchar *data = file.map(0, size);
+    if (!data) {
+        fprintf(stderr, "calc-cli: 无法映射文件: %s\n", path.toLocal8Bit().constData());
+        return -1;
+    }
+
+    qint64 failures = 0;
+    if (options.format == RawDump && size % 8) {
+        fprintf(stderr, "calc-cli: %s 的长度不是 8 的倍数，忽略末尾 %d 字节\n",
+                path.toLocal8Bit().constData(), int(size % 8));
+        size -= size % 8;
+        ++failures;
+    }
+
+    const int jobs = options.jobs > 0 ? options.jobs : qMax(1, QThread::idealThreadCount());
+    bool writeFailed = false;
+    {
+        DecodePool pool(jobs, plan, options.format);
+        qint64 pos = 0;
+        qint64 submitted = 0;
+        qint64 written = 0;
+        for (;;) {
+            // 空出的槽立即装入下一块；写出失败后不再装入，只等在途的块完成
+            while (!writeFailed && pos < size && submitted - written < pool.capacity()) {
+                ChunkDecoder &decoder = pool.slot(submitted);
+                const qint64 end = chunkEnd(data, pos, size, options.format, plan);
+                decoder.begin = data + pos;
+                decoder.end = data + end;
+                pos = end;
+                pool.submit(submitted++);
+            }
+            if (written == submitted) break;
+
+            const ChunkDecoder &decoder = pool.wait(written++);
+            failures += decoder.failures;
+            if (writeFailed) continue;
+            if (plan.columns) {
+                for (int f = 0; f < decoder.packed.size(); ++f)
+                    plan.columns->append(f, decoder.packed[f].constData(), decoder.packed[f].size());
+                plan.columns->addRows(decoder.rows);
+                if (plan.columns->hasError()) writeFailed = true;
+                continue;
+            }
+            if (fwrite(decoder.text.constData(), 1, size_t(decoder.text.size()), out) != size_t(decoder.text.size()))
+                writeFailed = true;
+        }
+    }
+
+    file.unmap(const_cast<uchar *>(data));
+    if (writeFailed) {
+        fputs("calc-cli: 写出结果失败\n", stderr);
+        return -1;
+    }
+    return failures;
+}
+
+} // namespace
+
+qint64 decodeDump(const QString &path, FILE *out, const DecodeOptions &options)
+{
+    return decodeFile(path, out, options, makePlan(options));
+}
+
+qint64 decodeDump(const QString &path, ColumnarWriter &columns, const DecodeOptions &options)
+{
+    return decodeFile(path, nullptr, options, makePlan(columns));
+}
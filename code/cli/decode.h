@@ -0,0 +1,37 @@
+#ifndef DECODE_H
+#define DECODE_H
+
+#include <QList>
+#include <QString>
+
+#include <cstdio>
+
+#include "splitlayout.h"
+
+class ColumnarWriter;
+
+// -------------------------------
+// 寄存器转储解码：内存映射整个文件，切成块分给各线程，每块按分割规则逐段提取（整列 pext）
+// 并直接格式化到字节缓冲区，按文件顺序写出；不经过 QString，线程常驻，主线程一边写出一边补充新的块
+// 规则按 64 位整字应用（高出规则的位作为最前面的剩余段），每行的段数都相同
+// -------------------------------
+enum DumpFormat {
+    RawDump,  // 小端 64 位二进制，连续存放
+    HexDump   // 每行一个十六进制数（可带 0x 前缀和分组空格）
+};
+
+struct DecodeOptions
+{
+    DumpFormat format = RawDump;
+    calc::SplitLayout layout;  // 为空时每行输出整个数值（十进制带符号）
+    QList<int> outputs;        // 输出进制，各进制之间以制表符分隔，段之间以 '|' 分隔
+    int jobs = 0;              // 解码线程数，0 表示按 CPU 核数
+};
+
+// 解码一个文件写到 out，返回无效数值的个数；无法打开、映射或写出时输出原因并返回 -1
+qint64 decodeDump(const QString &path, FILE *out, const DecodeOptions &options);
+
+// 同上，但各段按位宽编码后追加到列式文件的各列（layout 和 outputs 不使用，规则取自 columns）；无效的行不写入
+qint64 decodeDump(const QString &path, ColumnarWriter &columns, const DecodeOptions &options);
+
+#endif // DECODE_H
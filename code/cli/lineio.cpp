@@ -0,0 +1,79 @@
+#include "lineio.h"
+
+#include <cstring>
+
+LineReader::LineReader(FILE *file)
+    : file(file)
+    , begin(0)
+    , end(0)
+    , eof(false)
+{
+    buffer.resize(InitialCapacity);
+}
+
+bool LineReader::readLine(const char *&data, int &size)
+{
+    for (;;) {
+        const char *start = buffer.constData() + begin;
+        const char *newline = static_cast<const char *>(memchr(start, '\n', end - begin));
+        if (newline || (eof && begin < end)) {
+            data = start;
+            size = newline ? int(newline - start) : end - begin;
+            begin += newline ? size + 1 : size;
+            if (size > 0 && data[size - 1] == '\r') --size;
+            return true;
+        }
+        if (eof) return false;
+
+        // 把未消费的半行移到缓冲区开头，装不下时扩容
+        if (begin > 0) {
+            memmove(buffer.data(), start, end - begin);
+            end -= begin;
+            begin = 0;
+        }
+        if (end == buffer.size()) buffer.resize(buffer.size() * 2);
+
+        size_t n = fread(buffer.data() + end, 1, buffer.size() - end, file);
+        if (n == 0) eof = true;
+        end += int(n);
+    }
+}
+
+bool LineReader::hasError() const
+{
+    return ferror(file) != 0;
+}
+
+OutputWriter::OutputWriter(FILE *file)
+    : file(file)
+    , used(0)
+{
+}
+
+OutputWriter::~OutputWriter()
+{
+    flush();
+}
+
+void OutputWriter::write(const char *data, int size)
+{
+    if (used + size > Capacity) {
+        flush();
+        if (size > Capacity) {
+            fwrite(data, 1, size, file);
+            return;
+        }
+    }
+    memcpy(buffer + used, data, size);
+    used += size;
+}
+
+bool OutputWriter::flush()
+{
+    if (used > 0 && fwrite(buffer, 1, used, file) != size_t(used)) {
+        used = 0;
+        return false;
+    }
+    used = 0;
+    return fflush(file) == 0;
+}
@@ -0,0 +1,73 @@
+#ifndef LINEIO_H
+#define LINEIO_H
+
+#include <QByteArray>
+
+#include <cstdio>
+
+// -------------------------------
+// 大块缓冲的逐行读取，返回的数据指向内部缓冲区，下次读取前有效
+// -------------------------------
+class LineReader
+{
+public:
+    explicit LineReader(FILE *file);
+
+    // 读取下一行（不含换行符和行尾 '\r'），没有更多数据时返回 false
+    bool readLine(const char *&data, int &size);
+    bool hasError() const;
+
+private:
+    static const int InitialCapacity = 1 << 20;
+
+    FILE *file;
+    QByteArray buffer;
+    int begin; // 未消费数据的起点
+    int end;   // 已读入数据的终点
+    bool eof;
+};
+
+// -------------------------------
+// 缓冲输出，攒满后一次性写出
+// -------------------------------
+class OutputWriter
+{
+public:
+    explicit OutputWriter(FILE *file);
+    ~OutputWriter();
+
+    void write(const char *data, int size);
+    void write(const QByteArray &bytes) { write(bytes.constData(), bytes.size()); }
+    void write(char c)
+    {
+        if (used == Capacity) flush();
+        buffer[used++] = c;
+    }
+
+    bool flush();
+
+private:
+    static const int Capacity = 1 << 16;
+
+    FILE *file;
+    char buffer[Capacity];
+    int used;
+};
+
+// -------------------------------
+// 与 OutputWriter 相同的接口，追加到内存中的 QByteArray（批量计算的各任务各写各的，再按顺序写出）
+// -------------------------------
+class BufferWriter
+{
+public:
+    explicit BufferWriter(QByteArray &buffer) : buffer(buffer) {}
+
+    void write(const char *data, int size) { buffer.append(data, size); }
+    void write(const QByteArray &bytes) { buffer.append(bytes); }
+    void write(char c) { buffer.append(c); }
+
+private:
+    QByteArray &buffer;
+};
+
+#endif // LINEIO_H
@@ -0,0 +1,638 @@
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVarLengthArray>
+#include <QVector>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <QThread>
+
+#include "bytecode.h"
+#include "column.h"
+#include "columnar.h"
+#include "decode.h"
+#include "lineio.h"
+#include "radix.h"
+#include "scheduler.h"
+#include "splitlayout.h"
+#include "validator.h"
+
+// -------------------------------
+// calc-cli：逐行读取表达式并批量计算，不创建 QApplication
+// -------------------------------
+namespace {
+
+struct Options
+{
+    int base = calc::DEC;    // 表达式的进制
+    QList<int> outputs;      // 输出进制，按给定顺序以制表符分隔
+    QString splitRule;       // 分割规则原文，写入列式文件头
+    calc::SplitLayout split; // 分割规则（解析一次），为空时不分割
+    QString mapExpr;         // 列式模式：对每个输入值 x 计算的表达式
+    bool raw = false;        // 列式模式下输入输出为小端 64 位二进制
+    int valueBits = 64;      // 数值位宽：64 / 128 / 256 / 512
+    bool decode = false;     // 寄存器转储解码模式
+    DumpFormat dumpFormat = RawDump;
+    int jobs = 0;            // 解码和批量计算的线程数，0 表示按 CPU 核数
+    QString columnarPath;    // 解码结果写为列式文件
+    ColumnEncoding encoding = PlainEncoding;
+    QString scanPath;        // 扫描的列式文件
+    QList<int> scanFields;   // 扫描的列号，为空时只输出文件头
+    QStringList files;       // 输入文件，为空或 "-" 时读标准输入
+};
+
+// 列式模式每批处理的数值个数
+const int ColumnBatch = 1 << 16;
+
+void printUsage(FILE *out)
+{
+    fputs("用法: calc-cli [选项] [文件...]\n"
+          "逐行读取表达式（默认从标准输入），每行输出一个结果。\n"
+          "\n"
+          "选项:\n"
+          "  -b, --base <bin|oct|dec|hex>    表达式的进制（默认 dec）\n"
+          "  -o, --output <列表>             输出进制，逗号分隔，如 dec,hex（默认 dec）\n"
+          "  -s, --split <规则>              分割规则，如 1,2,4（从高位应用），按段输出\n"
+          "  -e, --map <表达式>              列式模式：每行输入一个数值作为 x，输出表达式的值\n"
+          "      --raw                       列式模式下输入输出均为小端 64 位二进制\n"
+          "  -w, --width <64|128|256|512>    数值位宽（默认 64），按该位宽补码运算和显示\n"
+          "  -d, --decode <raw|hex>          寄存器转储解码：内存映射输入文件，按 --split 规则多线程解码\n"
+          "                                  每个 64 位数值（raw 为小端二进制，hex 为每行一个十六进制数）\n"
+          "  -j, --jobs <n>                  解码和逐行计算表达式的线程数（默认为 CPU 核数，1 为单线程）\n"
+          "  -c, --columnar <文件>           与 --decode 一起使用：各段按位宽紧密打包，写为列式文件\n"
+          "      --encoding <plain|delta|rle|auto>\n"
+          "                                  列式文件各列的编码（默认 plain；不比 plain 小的块仍按 plain 存放，\n"
+          "                                  auto 为每块取三者中最小的一种）\n"
+          "      --scan <文件>               读取列式文件：不带 --fields 时输出规则和各列大小\n"
+          "  -f, --fields <列表>             只解码并输出这些列，逗号分隔，0 为最高位的段\n"
+          "  -h, --help                      显示本帮助\n"
+          "\n"
+          "非法表达式或数值输出 \"error: <原因>\"，并以退出码 1 结束。\n", out);
+}
+
+bool parseBase(const char *name, int &base)
+{
+    if (!strcmp(name, "bin")) base = calc::BIN;
+    else if (!strcmp(name, "oct")) base = calc::OCT;
+    else if (!strcmp(name, "dec")) base = calc::DEC;
+    else if (!strcmp(name, "hex")) base = calc::HEX;
+    else return false;
+    return true;
+}
+
+// 逗号分隔的列表，跳过空项；Qt 5.14 起 SkipEmptyParts 移到 Qt 命名空间，旧的写法已弃用
+QStringList splitList(const char *list)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    return QString::fromLatin1(list).split(QLatin1Char(','), Qt::SkipEmptyParts);
+#else
+    return QString::fromLatin1(list).split(QLatin1Char(','), QString::SkipEmptyParts);
+#endif
+}
+
+bool parseArguments(int argc, char *argv[], Options &options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        auto value = [&]() -> const char * {
+            return i + 1 < argc ? argv[++i] : nullptr;
+        };
+
+        if (!strcmp(arg, "-h") || !strcmp(arg, "--help")) {
+            printUsage(stdout);
+            exit(0);
+        } else if (!strcmp(arg, "-b") || !strcmp(arg, "--base")) {
+            const char *name = value();
+            if (!name || !parseBase(name, options.base)) {
+                fprintf(stderr, "calc-cli: 无效的进制: %s\n", name ? name : "");
+                return false;
+            }
+        } else if (!strcmp(arg, "-o") || !strcmp(arg, "--output")) {
+            const char *list = value();
+            if (!list) {
+                fputs("calc-cli: 缺少输出进制\n", stderr);
+                return false;
+            }
+            const QStringList names = splitList(list);
+            for (const QString &name : names) {
+                int base;
+                if (!parseBase(name.trimmed().toLatin1().constData(), base)) {
+                    fprintf(stderr, "calc-cli: 无效的输出进制: %s\n", name.toLocal8Bit().constData());
+                    return false;
+                }
+                options.outputs << base;
+            }
+        } else if (!strcmp(arg, "-s") || !strcmp(arg, "--split")) {
+            const char *rule = value();
+            if (!rule) {
+                fputs("calc-cli: 缺少分割规则\n", stderr);
+                return false;
+            }
+            options.splitRule = QString::fromLatin1(rule);
+            options.split = calc::SplitLayout(options.splitRule);
+        } else if (!strcmp(arg, "-e") || !strcmp(arg, "--map")) {
+            const char *expr = value();
+            if (!expr) {
+                fputs("calc-cli: 缺少表达式\n", stderr);
+                return false;
+            }
+            options.mapExpr = QString::fromUtf8(expr);
+        } else if (!strcmp(arg, "--raw")) {
+            options.raw = true;
+        } else if (!strcmp(arg, "-w") || !strcmp(arg, "--width")) {
+            const char *bits = value();
+            options.valueBits = bits ? atoi(bits) : 0;
+            if (!calc::isValueBits(options.valueBits)) {
+                fprintf(stderr, "calc-cli: 无效的位宽: %s\n", bits ? bits : "");
+                return false;
+            }
+        } else if (!strcmp(arg, "-d") || !strcmp(arg, "--decode")) {
+            const char *format = value();
+            if (format && !strcmp(format, "raw")) {
+                options.dumpFormat = RawDump;
+            } else if (format && !strcmp(format, "hex")) {
+                options.dumpFormat = HexDump;
+            } else {
+                fprintf(stderr, "calc-cli: 无效的转储格式: %s\n", format ? format : "");
+                return false;
+            }
+            options.decode = true;
+        } else if (!strcmp(arg, "-j") || !strcmp(arg, "--jobs")) {
+            const char *jobs = value();
+            options.jobs = jobs ? atoi(jobs) : 0;
+            if (options.jobs <= 0) {
+                fprintf(stderr, "calc-cli: 无效的线程数: %s\n", jobs ? jobs : "");
+                return false;
+            }
+        } else if (!strcmp(arg, "-c") || !strcmp(arg, "--columnar")) {
+            const char *path = value();
+            if (!path) {
+                fputs("calc-cli: 缺少列式文件名\n", stderr);
+                return false;
+            }
+            options.columnarPath = QString::fromLocal8Bit(path);
+        } else if (!strcmp(arg, "--encoding")) {
+            const char *name = value();
+            if (!name || !parseColumnEncoding(name, options.encoding)) {
+                fprintf(stderr, "calc-cli: 无效的编码: %s\n", name ? name : "");
+                return false;
+            }
+        } else if (!strcmp(arg, "--scan")) {
+            const char *path = value();
+            if (!path) {
+                fputs("calc-cli: 缺少列式文件名\n", stderr);
+                return false;
+            }
+            options.scanPath = QString::fromLocal8Bit(path);
+        } else if (!strcmp(arg, "-f") || !strcmp(arg, "--fields")) {
+            const char *list = value();
+            const QStringList numbers = splitList(list ? list : "");
+            if (numbers.isEmpty()) {
+                fputs("calc-cli: 缺少列号\n", stderr);
+                return false;
+            }
+            for (const QString &number : numbers) {
+                bool ok = false;
+                const int index = number.trimmed().toInt(&ok);
+                if (!ok || index < 0) {
+                    fprintf(stderr, "calc-cli: 无效的列号: %s\n", number.toLocal8Bit().constData());
+                    return false;
+                }
+                options.scanFields << index;
+            }
+        } else if (arg[0] == '-' && arg[1] != '\0') {
+            fprintf(stderr, "calc-cli: 未知选项: %s\n", arg);
+            return false;
+        } else {
+            options.files << QString::fromLocal8Bit(arg);
+        }
+    }
+
+    if (options.outputs.isEmpty()) options.outputs << calc::DEC;
+    if (options.raw && options.mapExpr.isEmpty()) {
+        fputs("calc-cli: --raw 只能与 --map 一起使用\n", stderr);
+        return false;
+    }
+    if (options.raw && options.valueBits != 64) {
+        fputs("calc-cli: --raw 只支持 64 位\n", stderr);
+        return false;
+    }
+    if (options.decode) {
+        if (!options.mapExpr.isEmpty() || options.valueBits != 64) {
+            fputs("calc-cli: --decode 不能与 --map 或 --width 一起使用\n", stderr);
+            return false;
+        }
+        if (options.split.totalBits() > 64) {
+            fputs("calc-cli: --decode 的分割规则不能超过 64 位\n", stderr);
+            return false;
+        }
+        if (options.files.isEmpty() || options.files.contains(QStringLiteral("-"))) {
+            fputs("calc-cli: --decode 需要输入文件（不支持标准输入）\n", stderr);
+            return false;
+        }
+    }
+    if (!options.columnarPath.isEmpty() && !options.decode) {
+        fputs("calc-cli: --columnar 只能与 --decode 一起使用\n", stderr);
+        return false;
+    }
+    if (!options.scanPath.isEmpty() && (options.decode || !options.mapExpr.isEmpty() || !options.files.isEmpty())) {
+        fputs("calc-cli: --scan 不能与 --decode、--map 或输入文件一起使用\n", stderr);
+        return false;
+    }
+    if (!options.scanFields.isEmpty() && options.scanPath.isEmpty()) {
+        fputs("calc-cli: --fields 只能与 --scan 一起使用\n", stderr);
+        return false;
+    }
+    return true;
+}
+
+// 将一行字节放入复用的 QString；含非 ASCII 字节时按 UTF-8 解码
+void assignLine(QString &target, const char *data, int size)
+{
+    for (int i = 0; i < size; ++i) {
+        if (static_cast<unsigned char>(data[i]) >= 0x80) {
+            target = QString::fromUtf8(data, size);
+            return;
+        }
+    }
+    target.resize(size);
+    QChar *out = target.data();
+    for (int i = 0; i < size; ++i) out[i] = QLatin1Char(data[i]);
+}
+
+// 与界面一致：十进制带符号，其余进制按 Bits 位补码显示，十六进制大写
+// Bits 为 64 时格式化函数直接走原生实现
+template<int Bits, typename Out>
+void writeNumber(Out &out, const calc::WideInt<Bits> &value, int base)
+{
+    char digits[calc::maxNumberChars(Bits)];
+    out.write(digits, calc::formatNumber(digits, value, base));
+}
+
+// 与结果框一致：按分割布局逐段输出（二进制段补零到段宽，不加空格）
+template<int Bits, typename Out>
+void writeSplit(Out &out, const calc::WideInt<Bits> &value, int base, const calc::SplitLayout &layout)
+{
+    const int valueBits = value.bitLength();
+    const int count = layout.fieldCount(valueBits);
+    if (count <= 1) {
+        writeNumber(out, value, base);
+        return;
+    }
+
+    QVarLengthArray<char, calc::maxNumberChars(Bits)> digits;
+    for (int i = 0; i < count; ++i) {
+        const calc::SplitField field = layout.field(i, valueBits);
+        const calc::WideInt<Bits> part = calc::SplitLayout::extract(value, field);
+        if (i > 0) out.write('|');
+        if (base == calc::BIN) {
+            digits.resize(field.width);
+            out.write(digits.data(), calc::formatBinField(digits.data(), part, field.width, false));
+        } else {
+            digits.resize(calc::maxNumberChars(Bits));
+            out.write(digits.data(), calc::formatUnsigned(digits.data(), part, base));
+        }
+    }
+}
+
+template<int Bits, typename Out>
+void writeValue(Out &out, const calc::WideInt<Bits> &value, const Options &options)
+{
+    for (int i = 0; i < options.outputs.size(); ++i) {
+        if (i > 0) out.write('\t');
+        if (options.split.isEmpty()) writeNumber(out, value, options.outputs[i]);
+        else writeSplit(out, value, options.outputs[i], options.split);
+    }
+    out.write('\n');
+}
+
+template<typename Out>
+void writeValue(Out &out, qint64 value, const Options &options)
+{
+    writeValue(out, calc::WideInt<64>::fromInt64(value), options);
+}
+
+// 按选项的位宽执行程序并输出；64 位走原生执行
+template<typename Out>
+void writeResult(Out &out, const calc::Program &program, const Options &options)
+{
+    switch (options.valueBits) {
+    case 128: writeValue(out, calc::execute(program, calc::WideInt<128>()), options); break;
+    case 256: writeValue(out, calc::execute(program, calc::WideInt<256>()), options); break;
+    case 512: writeValue(out, calc::execute(program, calc::WideInt<512>()), options); break;
+    default:  writeValue(out, calc::execute(program), options); break;
+    }
+}
+
+// 计算一行表达式，输出结果或 "error: <原因>"，返回表达式是否合法
+template<typename Out>
+bool evaluateLine(Out &out, const QString &line, const Options &options, calc::ProgramCache &cache,
+                  QString &errorMsg)
+{
+    if (!calc::validateExpression(line, options.base, errorMsg)) {
+        out.write("error: ", 7);
+        out.write(errorMsg.toUtf8());
+        out.write('\n');
+        return false;
+    }
+
+    const calc::Program &program = cache.get(line, options.base, options.valueBits);
+    if (!program.ok()) {
+        out.write("error: 表达式语法错误\n", int(strlen("error: 表达式语法错误\n")));
+        return false;
+    }
+    writeResult(out, program, options);
+    return true;
+}
+
+// 处理一个输入流，返回非法表达式的行数
+int processStream(FILE *in, OutputWriter &out, const Options &options, calc::ProgramCache &cache)
+{
+    LineReader reader(in);
+    QString line;
+    QString errorMsg;
+    const char *data;
+    int size;
+    int failures = 0;
+
+    while (reader.readLine(data, size)) {
+        assignLine(line, data, size);
+        if (!evaluateLine(out, line, options, cache, errorMsg)) ++failures;
+    }
+
+    if (reader.hasError()) {
+        fputs("calc-cli: 读取输入失败\n", stderr);
+        ++failures;
+    }
+    return failures;
+}
+
+// 批量计算时每个线程自己的暂存，线程之间不共享，不需要加锁
+struct BatchScratch
+{
+    calc::ProgramCache cache;
+    QString line;
+    QString errorMsg;
+};
+
+// 批量计算的一个任务：逐行计算（按行切分的规则同 LineReader），返回非法表达式的行数
+int processLines(const char *data, int size, BufferWriter &out, const Options &options, BatchScratch &scratch)
+{
+    const char *const end = data + size;
+    int failures = 0;
+    while (data < end) {
+        const char *newline = static_cast<const char *>(memchr(data, '\n', size_t(end - data)));
+        int length = int((newline ? newline : end) - data);
+        const char *next = newline ? newline + 1 : end;
+        if (length > 0 && data[length - 1] == '\r') --length;
+
+        assignLine(scratch.line, data, length);
+        if (!evaluateLine(out, scratch.line, options, scratch.cache, scratch.errorMsg)) ++failures;
+        data = next;
+    }
+    return failures;
+}
+
+// 解析一行数值（按表达式进制，十进制允许负号），忽略首尾空白
+// 十进制负数按 qint64 范围，其余按 64 位无符号（补码）；超出 64 位视为无效
+bool parseValue(const char *data, int size, int base, qint64 &value)
+{
+    while (size > 0 && (*data == ' ' || *data == '\t')) { ++data; --size; }
+    while (size > 0 && (data[size - 1] == ' ' || data[size - 1] == '\t')) --size;
+
+    const bool negative = size > 0 && *data == '-';
+    const calc::ParsedNumber parsed = negative ? calc::parseNumber(data, size, base)
+                                               : calc::parseUnsigned(data, size, base);
+    value = qint64(parsed.value);
+    return parsed.ok();
+}
+
+// 同上，按 Bits 位：十进制负数按 Bits 位有符号范围，其余按 Bits 位无符号
+template<int Bits>
+bool parseValue(const char *data, int size, int base, calc::WideInt<Bits> &value)
+{
+    while (size > 0 && (*data == ' ' || *data == '\t')) { ++data; --size; }
+    while (size > 0 && (data[size - 1] == ' ' || data[size - 1] == '\t')) --size;
+
+    const bool negative = size > 0 && *data == '-';
+    const calc::ParsedWideNumber<Bits> parsed = negative ? calc::parseNumber<Bits>(data, size, base)
+                                                         : calc::parseUnsigned<Bits>(data, size, base);
+    value = parsed.value;
+    return parsed.ok();
+}
+
+// 列式模式（二进制）：整批读入后原地执行，再整批写出
+int processRawColumn(FILE *in, FILE *out, const calc::Program &program)
+{
+    QVector<qint64> values(ColumnBatch);
+    size_t n;
+    while ((n = fread(values.data(), sizeof(qint64), ColumnBatch, in)) > 0) {
+        calc::executeColumn(program, values.constData(), values.data(), qsizetype(n));
+        if (fwrite(values.constData(), sizeof(qint64), n, out) != n) {
+            fputs("calc-cli: 写出结果失败\n", stderr);
+            return 1;
+        }
+    }
+    if (ferror(in)) {
+        fputs("calc-cli: 读取输入失败\n", stderr);
+        return 1;
+    }
+    return 0;
+}
+
+// 列式模式（文本）：每行一个数值，按批执行，非法数值所在行输出错误
+int processTextColumn(FILE *in, OutputWriter &out, const Options &options, const calc::Program &program)
+{
+    LineReader reader(in);
+    QVector<qint64> values;
+    QVector<bool> valid;
+    values.reserve(ColumnBatch);
+    valid.reserve(ColumnBatch);
+    int failures = 0;
+
+    auto flushBatch = [&]() {
+        calc::executeColumn(program, values.constData(), values.data(), values.size());
+        for (int i = 0; i < values.size(); ++i) {
+            if (valid[i]) {
+                writeValue(out, values[i], options);
+            } else {
+                out.write("error: 无效的数值\n", int(strlen("error: 无效的数值\n")));
+                ++failures;
+            }
+        }
+        values.clear();
+        valid.clear();
+    };
+
+    const char *data;
+    int size;
+    while (reader.readLine(data, size)) {
+        qint64 value = 0;
+        valid.append(parseValue(data, size, options.base, value));
+        values.append(value);
+        if (values.size() == ColumnBatch) flushBatch();
+    }
+    if (!values.isEmpty()) flushBatch();
+
+    if (reader.hasError()) {
+        fputs("calc-cli: 读取输入失败\n", stderr);
+        ++failures;
+    }
+    return failures;
+}
+
+// 列式模式（宽整数）：逐行解析并执行，没有列式内核
+template<int Bits>
+int processWideColumn(FILE *in, OutputWriter &out, const Options &options, const calc::Program &program)
+{
+    LineReader reader(in);
+    const char *data;
+    int size;
+    int failures = 0;
+    while (reader.readLine(data, size)) {
+        calc::WideInt<Bits> value;
+        if (parseValue(data, size, options.base, value)) {
+            writeValue(out, calc::execute(program, value), options);
+        } else {
+            out.write("error: 无效的数值\n", int(strlen("error: 无效的数值\n")));
+            ++failures;
+        }
+    }
+
+    if (reader.hasError()) {
+        fputs("calc-cli: 读取输入失败\n", stderr);
+        ++failures;
+    }
+    return failures;
+}
+
+int processColumn(FILE *in, OutputWriter &out, const Options &options, const calc::Program &program)
+{
+    switch (options.valueBits) {
+    case 128: return processWideColumn<128>(in, out, options, program);
+    case 256: return processWideColumn<256>(in, out, options, program);
+    case 512: return processWideColumn<512>(in, out, options, program);
+    default:  return processTextColumn(in, out, options, program);
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage(stderr);
+        return 2;
+    }
+
+    // 列式模式下表达式只校验、编译一次
+    calc::Program mapProgram;
+    if (!options.mapExpr.isEmpty()) {
+        QString errorMsg;
+        if (!calc::validateExpression(options.mapExpr, options.base, errorMsg)) {
+            fprintf(stderr, "calc-cli: 表达式错误: %s\n", errorMsg.toLocal8Bit().constData());
+            return 2;
+        }
+        mapProgram = calc::compile(options.mapExpr, options.base, options.valueBits);
+        if (!mapProgram.ok()) {
+            fputs("calc-cli: 表达式错误: 表达式语法错误\n", stderr);
+            return 2;
+        }
+    }
+
+    // 列式文件：只映射并解码选中的列
+    if (!options.scanPath.isEmpty())
+        return scanColumnar(options.scanPath, options.scanFields, options.outputs, stdout) < 0 ? 2 : 0;
+
+    // 转储解码：各文件依次映射并多线程解码，直接写到标准输出，或者各文件的行依次追加到同一个列式文件
+    if (options.decode) {
+        DecodeOptions decode;
+        decode.format = options.dumpFormat;
+        decode.layout = options.split;
+        decode.outputs = options.outputs;
+        decode.jobs = options.jobs;
+        ColumnarWriter columns(options.splitRule, options.encoding);
+        const bool columnar = !options.columnarPath.isEmpty();
+        qint64 invalid = 0;
+        bool ok = !columnar || columns.open(options.columnarPath);
+        for (const QString &name : options.files) {
+            if (!ok) break;
+            const qint64 result = columnar ? decodeDump(name, columns, decode) : decodeDump(name, stdout, decode);
+            if (result < 0) {
+                ok = false;
+                break;
+            }
+            invalid += result;
+        }
+        // 出错时仍然写出已解码的部分，列式文件则整体放弃
+        if (ok && columnar) ok = columns.finish();
+        if (fflush(stdout) != 0) {
+            fputs("calc-cli: 写出结果失败\n", stderr);
+            ok = false;
+        }
+        if (!ok) return 2;
+        return invalid > 0 ? 1 : 0;
+    }
+
+    OutputWriter out(stdout);
+    calc::ProgramCache cache;
+    qint64 failures = 0;
+
+    // 逐行计算表达式：多线程时经工作窃取调度，各线程用自己的程序缓存，结果按输入顺序写出
+    const int jobs = options.jobs > 0 ? options.jobs : qMax(1, QThread::idealThreadCount());
+    std::vector<BatchScratch> scratch;
+    std::unique_ptr<BatchScheduler> scheduler;
+    if (jobs > 1 && options.mapExpr.isEmpty()) {
+        scratch.resize(size_t(jobs));
+        scheduler.reset(new BatchScheduler(jobs, [&](int worker, const char *data, int size, QByteArray &text) {
+            BufferWriter writer(text);
+            return processLines(data, size, writer, options, scratch[size_t(worker)]);
+        }));
+    }
+
+    if (options.files.isEmpty()) options.files << QStringLiteral("-");
+    // 出错时跳出循环而不是直接返回，保证输入文件关闭、已算出的结果写出
+    bool ok = true;
+    for (const QString &name : options.files) {
+        FILE *in = stdin;
+        if (name != "-") {
+            in = fopen(name.toLocal8Bit().constData(), "rb");
+            if (!in) {
+                fprintf(stderr, "calc-cli: 无法打开文件: %s\n", name.toLocal8Bit().constData());
+                ok = false;
+                break;
+            }
+        }
+
+        qint64 result;
+        if (options.raw) {
+            result = processRawColumn(in, stdout, mapProgram);
+        } else if (!options.mapExpr.isEmpty()) {
+            result = processColumn(in, out, options, mapProgram);
+        } else if (scheduler) {
+            result = scheduler->run(in, stdout);
+        } else {
+            result = processStream(in, out, options, cache);
+        }
+
+        if (in != stdin) fclose(in);
+        if (result < 0) {
+            ok = false;
+            break;
+        }
+        failures += result;
+    }
+
+    if (!out.flush()) {
+        fputs("calc-cli: 写出结果失败\n", stderr);
+        return 2;
+    }
+    if (!ok) return 2;
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,195 @@
+#include "scheduler.h"
+
+#include <cstring>
+
+namespace {
+
+// 每个任务的目标字节数：计算量大致与表达式长度成正比，按字节切分比按行数均匀
+const int TaskBytes = 8 << 10;
+// 每个线程在途的任务数：足够窃取，又不让重排缓冲区占用过多内存
+const int TasksPerWorker = 64;
+const int MinSlots = 256;
+const int ReadBlock = 1 << 20;
+
+// -------------------------------
+// 按整行切分输入：每块从 TaskBytes 处延伸到下一个换行之后
+// -------------------------------
+class TaskReader
+{
+public:
+    explicit TaskReader(FILE *file) : file(file) { buffer.resize(ReadBlock); }
+
+    // 取下一块到 out，没有更多输入时返回 false
+    bool next(QByteArray &out)
+    {
+        for (;;) {
+            const int from = qMin(begin + TaskBytes - 1, end);
+            const void *newline = memchr(buffer.constData() + from, '\n', size_t(end - from));
+            if (newline || (eof && begin < end)) {
+                const int cut = newline ? int(static_cast<const char *>(newline) - buffer.constData()) + 1 : end;
+                out.resize(cut - begin);
+                memcpy(out.data(), buffer.constData() + begin, size_t(cut - begin));
+                begin = cut;
+                return true;
+            }
+            if (eof) return false;
+            fill();
+        }
+    }
+
+    bool hasError() const { return ferror(file) != 0; }
+
+private:
+    // 把未切出的部分移到开头，装不下一块时扩容，再读入
+    void fill()
+    {
+        if (begin > 0) {
+            memmove(buffer.data(), buffer.constData() + begin, size_t(end - begin));
+            end -= begin;
+            begin = 0;
+        }
+        if (buffer.size() - end < ReadBlock / 2) buffer.resize(buffer.size() * 2);
+        const size_t n = fread(buffer.data() + end, 1, size_t(buffer.size() - end), file);
+        if (n == 0) eof = true;
+        end += int(n);
+    }
+
+    FILE *file;
+    QByteArray buffer;
+    int begin = 0;
+    int end = 0;
+    bool eof = false;
+};
+
+} // namespace
+
+BatchScheduler::BatchScheduler(int jobs, const Task &task)
+    : task(task)
+{
+    jobs = qMax(1, jobs);
+    for (int i = 0; i < jobs; ++i) queues.emplace_back(new WorkerQueue);
+    slots.resize(size_t(qMax(MinSlots, jobs * TasksPerWorker)));
+    for (int i = 0; i < jobs; ++i) threads.emplace_back(&BatchScheduler::work, this, i);
+}
+
+BatchScheduler::~BatchScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    workReady.notify_all();
+    for (std::thread &thread : threads) thread.join();
+}
+
+// 轮流放进各线程的队列尾部
+void BatchScheduler::push(qint64 seq)
+{
+    WorkerQueue &queue = *queues[size_t(seq % qint64(queues.size()))];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(seq);
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        ++queued;
+    }
+    workReady.notify_one();
+}
+
+// 先取自己队列头部最早的任务，再依次从其他线程的队列尾部窃取
+bool BatchScheduler::take(int worker, qint64 &seq)
+{
+    const int count = int(queues.size());
+    for (int i = 0; i < count; ++i) {
+        WorkerQueue &queue = *queues[size_t((worker + i) % count)];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) continue;
+        if (i == 0) {
+            seq = queue.tasks.front();
+            queue.tasks.pop_front();
+        } else {
+            seq = queue.tasks.back();
+            queue.tasks.pop_back();
+        }
+        return true;
+    }
+    return false;
+}
+
+void BatchScheduler::work(int worker)
+{
+    for (;;) {
+        qint64 seq;
+        if (!take(worker, seq)) {
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            workReady.wait(lock, [this]() { return queued > 0 || stopping; });
+            if (queued == 0) return;
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            --queued;
+        }
+
+        Slot &slot = slots[size_t(seq % qint64(slots.size()))];
+        slot.output.clear();
+        slot.failures = task(worker, slot.input.constData(), slot.input.size(), slot.output);
+        {
+            std::lock_guard<std::mutex> lock(doneMutex);
+            slot.done = true;
+        }
+        taskDone.notify_one();
+    }
+}
+
+// -------------------------------
+// 主线程：读入并分发，直到在途的任务占满重排缓冲区；按序号写出已完成的任务
+// -------------------------------
+qint64 BatchScheduler::run(FILE *in, FILE *out)
+{
+    TaskReader reader(in);
+    const qint64 capacity = qint64(slots.size());
+    qint64 nextRead = 0;
+    qint64 nextWrite = 0;
+    qint64 failures = 0;
+    bool eof = false;
+    bool writeFailed = false;
+
+    while (!eof || nextWrite < nextRead) {
+        while (!eof && nextRead - nextWrite < capacity) {
+            Slot &slot = slots[size_t(nextRead % capacity)];
+            if (!reader.next(slot.input)) {
+                eof = true;
+                break;
+            }
+            slot.done = false;
+            push(nextRead++);
+        }
+
+        // 还能继续读入时只写出已完成的，否则等最早的一个完成
+        while (nextWrite < nextRead) {
+            Slot &slot = slots[size_t(nextWrite % capacity)];
+            {
+                std::unique_lock<std::mutex> lock(doneMutex);
+                if (!slot.done && !eof && nextRead - nextWrite < capacity) break;
+                taskDone.wait(lock, [&slot]() { return slot.done; });
+            }
+            failures += slot.failures;
+            if (!writeFailed && fwrite(slot.output.constData(), 1, size_t(slot.output.size()), out)
+                    != size_t(slot.output.size()))
+                writeFailed = true;
+            ++nextWrite;
+        }
+    }
+
+    if (reader.hasError()) {
+        fputs("calc-cli: 读取输入失败\n", stderr);
+        return -1;
+    }
+    if (writeFailed) {
+        fputs("calc-cli: 写出结果失败\n", stderr);
+        return -1;
+    }
+    return failures;
+}
@@ -0,0 +1,70 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <QByteArray>
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// -------------------------------
+// 批量计算的工作窃取调度：输入按字节数切成若干整行的任务（超长的一行单独成为一个任务），
+// 依次放进各线程自己的双端队列；线程从自己队列的头部取最早的任务，空了就从别的线程队列的尾部窃取，
+// 一个很长的表达式拖住某个线程时，排在它后面的任务被其他线程取走，不会在末尾只剩一个核在算
+// 结果经重排缓冲区按输入顺序写出：主线程一边读入、分发，一边按序号写出已完成的任务，
+// 在途的任务数有上限，输入再大内存也有界
+// -------------------------------
+class BatchScheduler
+{
+public:
+    // 处理一块输入（若干整行，最后一行可能没有换行符），输出追加到 out，返回出错的行数
+    // worker 为执行它的线程编号（0 .. jobs - 1），调用方按它取各线程自己的暂存（程序缓存等），不需要加锁
+    typedef std::function<int(int worker, const char *data, int size, QByteArray &out)> Task;
+
+    BatchScheduler(int jobs, const Task &task);
+    ~BatchScheduler();
+
+    // 读入 in 的全部行，按输入顺序把结果写到 out，返回出错的行数；读取或写出失败时输出原因并返回 -1
+    qint64 run(FILE *in, FILE *out);
+
+private:
+    // 重排缓冲区的一格：一个任务的输入、输出和完成标志
+    struct Slot
+    {
+        QByteArray input;
+        QByteArray output;
+        int failures = 0;
+        bool done = false;   // 受 doneMutex 保护
+    };
+
+    // 一个线程的任务队列，存放任务的序号
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<qint64> tasks;
+    };
+
+    void push(qint64 seq);
+    bool take(int worker, qint64 &seq);
+    void work(int worker);
+
+    Task task;
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<Slot> slots;
+    std::vector<std::thread> threads;
+
+    std::mutex sleepMutex;              // 空闲的线程在 workReady 上等待
+    std::condition_variable workReady;
+    qint64 queued = 0;                  // 各队列中的任务总数，受 sleepMutex 保护
+    bool stopping = false;
+
+    std::mutex doneMutex;               // 主线程在 taskDone 上等待下一个要写出的任务
+    std::condition_variable taskDone;
+};
+
+#endif // SCHEDULER_H
@@ -0,0 +1,23 @@
+QT = core network
+
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+TARGET = calc-client
+
+include(../engine/engine.pri)
+
+# 与服务端共用请求 / 应答的编解码
+INCLUDEPATH += ../server
+
+SOURCES += \
+    main.cpp \
+    ../server/protocol.cpp
+
+HEADERS += \
+    ../server/protocol.h
+
+# Default rules for deployment.
+qnx: target.path = /tmp/cal/bin
+else: unix:!android: target.path = /opt/cal/bin
+!isEmpty(target.path): INSTALLS += target
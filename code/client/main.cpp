@@ -0,0 +1,351 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QList>
+#include <QLocalSocket>
+#include <QString>
+#include <QStringList>
+#include <QVarLengthArray>
+#include <QVector>
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+
+#include "protocol.h"
+
+// -------------------------------
+// calc-client：calc-server 的测试客户端和压力生成器
+// 逐行读取表达式，流水线式地发送（最多 depth 个请求未收到应答），按顺序输出结果，格式与 calc-cli 相同
+// --load 时循环发送这些表达式 n 次、不输出结果，报告吞吐和延迟分位数
+// -------------------------------
+namespace {
+
+// 等待应答的超时（毫秒）
+const int ReplyTimeout = 30000;
+
+struct Options
+{
+    QString name = QStringLiteral("calc-server");
+    EvalRequest request;     // 进制、位宽和分割规则，各请求相同
+    QList<int> outputs;      // 输出进制
+    int depth = 1024;        // 未收到应答的请求数上限
+    qint64 load = 0;         // 压力模式的请求总数，0 表示逐行输出结果
+    QStringList files;
+};
+
+void printUsage(FILE *out)
+{
+    fputs("用法: calc-client [选项] [文件...]\n"
+          "逐行读取表达式（默认从标准输入）发给 calc-server，每行输出一个结果。\n"
+          "\n"
+          "选项:\n"
+          "  -n, --name <名称>               服务端的套接字名称或路径（默认 calc-server）\n"
+          "  -b, --base <bin|oct|dec|hex>    表达式的进制（默认 dec）\n"
+          "  -w, --width <64|128|256|512>    数值位宽（默认 64）\n"
+          "  -s, --split <规则>              分割规则，如 1,2,4，按段输出\n"
+          "  -o, --output <列表>             输出进制，逗号分隔（默认 dec）\n"
+          "  -p, --depth <n>                 流水线深度：未收到应答的请求数上限（默认 1024）\n"
+          "  -l, --load <n>                  压力模式：循环发送输入的表达式共 n 次（不超过 2147483647），\n"
+          "                                  报告吞吐和延迟（从写出请求到收到应答）\n"
+          "  -h, --help                      显示本帮助\n", out);
+}
+
+bool parseBase(const char *name, int &base)
+{
+    if (!strcmp(name, "bin")) base = calc::BIN;
+    else if (!strcmp(name, "oct")) base = calc::OCT;
+    else if (!strcmp(name, "dec")) base = calc::DEC;
+    else if (!strcmp(name, "hex")) base = calc::HEX;
+    else return false;
+    return true;
+}
+
+// 逗号分隔的列表，跳过空项；Qt 5.14 起 SkipEmptyParts 移到 Qt 命名空间，旧的写法已弃用
+QStringList splitList(const char *list)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    return QString::fromLatin1(list).split(QLatin1Char(','), Qt::SkipEmptyParts);
+#else
+    return QString::fromLatin1(list).split(QLatin1Char(','), QString::SkipEmptyParts);
+#endif
+}
+
+bool parseArguments(int argc, char *argv[], Options &options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        auto take = [&]() { ++i; return value; };
+
+        if (!strcmp(arg, "-h") || !strcmp(arg, "--help")) {
+            printUsage(stdout);
+            exit(0);
+        } else if ((!strcmp(arg, "-n") || !strcmp(arg, "--name")) && value) {
+            options.name = QString::fromLocal8Bit(take());
+        } else if ((!strcmp(arg, "-b") || !strcmp(arg, "--base")) && value) {
+            if (!parseBase(take(), options.request.base)) {
+                fprintf(stderr, "calc-client: 无效的进制: %s\n", value);
+                return false;
+            }
+        } else if ((!strcmp(arg, "-w") || !strcmp(arg, "--width")) && value) {
+            options.request.valueBits = atoi(take());
+            if (!calc::isValueBits(options.request.valueBits)) {
+                fprintf(stderr, "calc-client: 无效的位宽: %s\n", value);
+                return false;
+            }
+        } else if ((!strcmp(arg, "-s") || !strcmp(arg, "--split")) && value) {
+            options.request.rule = QString::fromLatin1(take());
+        } else if ((!strcmp(arg, "-o") || !strcmp(arg, "--output")) && value) {
+            const QStringList names = splitList(take());
+            for (const QString &name : names) {
+                int base;
+                if (!parseBase(name.trimmed().toLatin1().constData(), base)) {
+                    fprintf(stderr, "calc-client: 无效的输出进制: %s\n", name.toLocal8Bit().constData());
+                    return false;
+                }
+                options.outputs << base;
+            }
+        } else if ((!strcmp(arg, "-p") || !strcmp(arg, "--depth")) && value) {
+            options.depth = atoi(take());
+            if (options.depth <= 0) {
+                fprintf(stderr, "calc-client: 无效的流水线深度: %s\n", value);
+                return false;
+            }
+        } else if ((!strcmp(arg, "-l") || !strcmp(arg, "--load")) && value) {
+            options.load = atoll(take());
+            // 每个请求的延迟都要记下来排序，总数受 QVector 的 int 下标限制
+            if (options.load <= 0 || options.load > INT_MAX) {
+                fprintf(stderr, "calc-client: 无效的请求数: %s\n", value);
+                return false;
+            }
+        } else if (arg[0] == '-' && arg[1] != '\0') {
+            fprintf(stderr, "calc-client: 未知选项或缺少参数: %s\n", arg);
+            return false;
+        } else {
+            options.files << QString::fromLocal8Bit(arg);
+        }
+    }
+    if (options.outputs.isEmpty()) options.outputs << calc::DEC;
+    if (options.request.rule.toUtf8().size() > MaxTextBytes) {
+        fputs("calc-client: 分割规则过长\n", stderr);
+        return false;
+    }
+    return true;
+}
+
+// 读入所有输入行（去掉行尾的 '\r'），无法打开时返回 false
+bool readLines(const QStringList &files, QStringList &lines)
+{
+    for (const QString &name : files) {
+        QFile file(name);
+        const bool opened = name == "-" ? file.open(stdin, QIODevice::ReadOnly) : file.open(QIODevice::ReadOnly);
+        if (!opened) {
+            fprintf(stderr, "calc-client: 无法打开文件: %s\n", name.toLocal8Bit().constData());
+            return false;
+        }
+        const QList<QByteArray> data = file.readAll().split('\n');
+        for (int i = 0; i < data.size(); ++i) {
+            QByteArray line = data[i];
+            if (i == data.size() - 1 && line.isEmpty()) break;
+            if (line.endsWith('\r')) line.chop(1);
+            lines << QString::fromUtf8(line);
+        }
+    }
+    return true;
+}
+
+// -------------------------------
+// 流水线：先发出 depth 个请求，之后每收到一批应答就补发同样多个，请求攒成一次写出
+// makeRequest(i, out) 把第 i 个请求追加到 out，onReply(i, reply) 按顺序处理第 i 个应答
+// onWritten(first, end)（可选）在第 [first, end) 个请求交给套接字并尽量写出之后调用
+// -------------------------------
+bool pipeline(QLocalSocket &socket, qint64 total, int depth,
+              const std::function<void(qint64, QByteArray &)> &makeRequest,
+              const std::function<void(qint64, const EvalReply &)> &onReply,
+              const std::function<void(qint64, qint64)> &onWritten = nullptr)
+{
+    QByteArray out;
+    QByteArray in;
+    EvalReply reply;
+    qint64 sent = 0;
+    qint64 received = 0;
+
+    while (received < total) {
+        const qint64 first = sent;
+        while (sent < total && sent - received < depth) makeRequest(sent++, out);
+        if (!out.isEmpty()) {
+            socket.write(out);
+            socket.flush();
+            out.clear();
+            if (onWritten) onWritten(first, sent);
+        }
+        if (!socket.waitForReadyRead(ReplyTimeout)) {
+            fprintf(stderr, "calc-client: 等待应答失败: %s\n", socket.errorString().toLocal8Bit().constData());
+            return false;
+        }
+
+        in.append(socket.readAll());
+        int pos = 0;
+        FrameResult result;
+        while ((result = takeReply(in, pos, reply)) == FrameComplete) onReply(received++, reply);
+        in.remove(0, pos);
+        if (result == FrameInvalid) {
+            fputs("calc-client: 无效的应答\n", stderr);
+            return false;
+        }
+    }
+    return true;
+}
+
+// 与 calc-cli 一致：十进制带符号，其余进制按位宽补码显示；分割时各段按无符号输出，二进制段补零到段宽
+template<int Bits>
+void appendNumber(QByteArray &line, const calc::WideValue &value, int base)
+{
+    char digits[calc::maxNumberChars(Bits)];
+    line.append(digits, calc::formatNumber(digits, calc::widthCast<Bits>(value), base));
+}
+
+void appendValue(QByteArray &line, const EvalReply &reply, const QList<int> &outputs)
+{
+    QVarLengthArray<char, calc::maxNumberChars(calc::MaxValueBits)> digits;
+    for (int b = 0; b < outputs.size(); ++b) {
+        const int base = outputs[b];
+        if (b > 0) line.append('\t');
+        if (reply.fields.isEmpty()) {
+            switch (reply.valueBits) {
+            case 128: appendNumber<128>(line, reply.value, base); break;
+            case 256: appendNumber<256>(line, reply.value, base); break;
+            case 512: appendNumber<512>(line, reply.value, base); break;
+            default:  appendNumber<64>(line, reply.value, base); break;
+            }
+            continue;
+        }
+        for (int f = 0; f < reply.fields.size(); ++f) {
+            const ReplyField &field = reply.fields[f];
+            if (f > 0) line.append('|');
+            if (base == calc::BIN) {
+                digits.resize(qMax(field.width, calc::maxNumberChars(calc::MaxValueBits)));
+                line.append(digits.data(), calc::formatBinField(digits.data(), field.value, field.width, false));
+            } else {
+                digits.resize(calc::maxNumberChars(calc::MaxValueBits));
+                line.append(digits.data(), calc::formatUnsigned(digits.data(), field.value, base));
+            }
+        }
+    }
+}
+
+// 逐行输出结果，返回出错的行数；连接中断时返回 -1
+qint64 printResults(QLocalSocket &socket, const Options &options, const QStringList &lines)
+{
+    EvalRequest request = options.request;
+    QByteArray text;
+    qint64 failures = 0;
+
+    auto flush = [&]() {
+        fwrite(text.constData(), 1, size_t(text.size()), stdout);
+        text.clear();
+    };
+    const bool ok = pipeline(socket, lines.size(), options.depth,
+        [&](qint64 i, QByteArray &out) {
+            request.expr = lines[int(i)];
+            appendRequest(out, request);
+        },
+        [&](qint64, const EvalReply &reply) {
+            if (reply.status == ReplyOk) {
+                appendValue(text, reply, options.outputs);
+            } else {
+                text.append("error: ");
+                text.append(reply.message.toUtf8());
+                ++failures;
+            }
+            text.append('\n');
+            if (text.size() >= (1 << 16)) flush();
+        });
+    flush();
+    return ok ? failures : -1;
+}
+
+// 压力模式：循环发送输入的表达式，记录每个请求从写出到收到应答的时间
+// 一批请求按写出（flush）之后的时刻计时，不含在客户端排队和编码的时间；
+// 系统的套接字缓冲区已满时未写完的部分仍在客户端等待，这段时间计入延迟
+bool runLoad(QLocalSocket &socket, const Options &options, const QStringList &lines)
+{
+    EvalRequest request = options.request;
+    QVector<qint64> sentAt(options.depth);
+    QVector<qint64> latencies(int(options.load));
+    qint64 failures = 0;
+    QElapsedTimer clock;
+    clock.start();
+
+    const bool ok = pipeline(socket, options.load, options.depth,
+        [&](qint64 i, QByteArray &out) {
+            request.expr = lines[int(i % lines.size())];
+            appendRequest(out, request);
+        },
+        [&](qint64 i, const EvalReply &reply) {
+            latencies[int(i)] = clock.nsecsElapsed() - sentAt[int(i % options.depth)];
+            if (reply.status != ReplyOk) ++failures;
+        },
+        [&](qint64 first, qint64 end) {
+            const qint64 now = clock.nsecsElapsed();
+            for (qint64 i = first; i < end; ++i) sentAt[int(i % options.depth)] = now;
+        });
+    const qint64 elapsed = clock.nsecsElapsed();
+    if (!ok) return false;
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) {
+        return latencies[qMin(latencies.size() - 1, int(p * latencies.size()))] / 1000.0;
+    };
+    printf("请求: %lld（出错 %lld），流水线深度 %d\n", static_cast<long long>(options.load),
+           static_cast<long long>(failures), options.depth);
+    printf("耗时: %.3f s，吞吐: %.0f 次/秒\n", elapsed / 1e9, options.load * 1e9 / elapsed);
+    printf("延迟: p50 %.1f us，p99 %.1f us，p99.9 %.1f us，最大 %.1f us\n",
+           percentile(0.5), percentile(0.99), percentile(0.999), latencies.last() / 1000.0);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage(stderr);
+        return 2;
+    }
+
+    QStringList lines;
+    if (options.files.isEmpty()) options.files << QStringLiteral("-");
+    if (!readLines(options.files, lines)) return 2;
+    for (const QString &line : lines) {
+        if (line.toUtf8().size() > MaxTextBytes) {
+            fputs("calc-client: 表达式过长\n", stderr);
+            return 2;
+        }
+    }
+    if (options.load > 0 && lines.isEmpty()) {
+        fputs("calc-client: 压力模式需要至少一个表达式\n", stderr);
+        return 2;
+    }
+
+    QLocalSocket socket;
+    socket.connectToServer(options.name);
+    if (!socket.waitForConnected(ReplyTimeout)) {
+        fprintf(stderr, "calc-client: 无法连接 %s: %s\n", options.name.toLocal8Bit().constData(),
+                socket.errorString().toLocal8Bit().constData());
+        return 2;
+    }
+
+    if (options.load > 0) return runLoad(socket, options, lines) ? 0 : 2;
+
+    const qint64 failures = printResults(socket, options, lines);
+    if (failures < 0) return 2;
+    return failures > 0 ? 1 : 0;
+}
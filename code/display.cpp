@@ -1,7 +1,11 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 
-#include <QStringList>
+#include <QTimer>
+#include <QVarLengthArray>
+
+#include "format.h"
+#include "trace.h"
 
 // -------------------------------
 // 工具函数
@@ -21,6 +25,10 @@ void MainWindow::setButtonEnabledByBase(Base base)
     ui->btnComma->setEnabled(ui->editSplitRule->hasFocus());
 
     // 更新UI提示（可选：改变背景色区分当前进制）
+    // 样式表每次设置都会重新 polish 控件，进制不变时跳过
+    if (base == styledBase) return;
+    styledBase = base;
+
     QString style = "QLineEdit { background-color: #FFFFFF; }";
     QString activeStyle = "QLineEdit { background-color: #E1F5FE; border: 1px solid #03A9F4; }";
 
@@ -30,146 +38,136 @@ void MainWindow::setButtonEnabledByBase(Base base)
     ui->editBin->setStyleSheet(base == BIN ? activeStyle : style);
 }
 
-void MainWindow::updateAllDisplays(long long value)
+// -------------------------------
+// 显示模型：合并同一轮事件循环内的多次更新
+// -------------------------------
+void MainWindow::updateAllDisplays(const calc::WideValue &value)
 {
-    // 保存所有输入框的光标位置
-    QMap<QLineEdit*, int> cursorPositions;
-    cursorPositions[ui->editDec] = ui->editDec->cursorPosition();
-    cursorPositions[ui->editHex] = ui->editHex->cursorPosition();
-    cursorPositions[ui->editOct] = ui->editOct->cursorPosition();
-    cursorPositions[ui->editBin] = ui->editBin->cursorPosition();
-    cursorPositions[ui->editBinResult] = ui->editBinResult->cursorPosition();
-    cursorPositions[ui->editDecResult] = ui->editDecResult->cursorPosition();
-    cursorPositions[ui->editHexResult] = ui->editHexResult->cursorPosition();
-    cursorPositions[ui->editExpression] = ui->editExpression->cursorPosition();
-    cursorPositions[ui->editSplitRule] = ui->editSplitRule->cursorPosition();
-
-    // 更新基础显示
-    ui->editDec->setText(QString::number(value, 10));
-    ui->editHex->setText(QString::number(value, 16).toUpper());
-    ui->editOct->setText(QString::number(value, 8));
-    QString rawBin = QString::number(value, 2);
-    ui->editBin->setText(formatBinWithSpaces(rawBin));
-
-    // 获取新的分割结果
-    QString splitRule = ui->editSplitRule->text();
-    QString formattedBin = formatBinWithSplit(rawBin, splitRule);
-    ui->editBinResult->setText(formattedBin);
-
-    // 如果没有分割，显示原始值
-    if (splitRule.isEmpty() || !formattedBin.contains('|')) {
-        ui->editDecResult->setText(ui->editDec->text());
-        ui->editHexResult->setText(ui->editHex->text());
-        // 恢复所有输入框的光标位置
-        for (auto it = cursorPositions.begin(); it != cursorPositions.end(); ++it) {
-            QLineEdit* edit = it.key();
-            int savedPos = it.value();
-            int maxPos = edit->text().length();
-            int restorePos = qMin(savedPos, maxPos);
-            edit->setCursorPosition(restorePos);
-        }
-        return;
-    }
+    TRACE_SCOPE("updateAllDisplays");
+    display.value = value;
+    display.valid = true;
+    markDisplaysDirty(ValueFields | SplitFields);
+}
 
-    // 处理每一段的 DEC 和 HEX
-    QStringList binParts = formattedBin.split('|');
-    QStringList decParts;
-    QStringList hexParts;
+void MainWindow::setValueBits(int valueBits)
+{
+    if (valueBits == display.valueBits) return;
 
-    for (const QString &part : binParts) {
-        if (part.isEmpty()) {
-            decParts << "0";
-            hexParts << "0";
-            continue;
-        }
-        bool ok;
-        // 注意：每一段都是一个独立的二进制数
-        // 移除空格以便解析
-        QString cleanPart = part;
-        cleanPart.remove(' ');
-        long long partVal = cleanPart.toLongLong(&ok, 2);
-        if (ok) {
-            decParts << QString::number(partVal, 10);
-            hexParts << QString::number(partVal, 16).toUpper();
-        }
-    }
+    // 变窄时截掉高位；补码位数变化后各进制的文本都要重新生成
+    display.valueBits = valueBits;
+    display.value = calc::truncateTo(display.value, valueBits);
+    markDisplaysDirty(ValueFields | SplitFields);
+}
 
-    ui->editDecResult->setText(decParts.join('|'));
-    ui->editHexResult->setText(hexParts.join('|'));
+void MainWindow::markDisplaysDirty(uint fields)
+{
+    display.dirty |= fields;
+    if (display.scheduled) return;
 
-    // 恢复所有输入框的光标位置
-    for (auto it = cursorPositions.begin(); it != cursorPositions.end(); ++it) {
-        QLineEdit* edit = it.key();
-        int savedPos = it.value();
-        int maxPos = edit->text().length();
-        int restorePos = qMin(savedPos, maxPos);
-        edit->setCursorPosition(restorePos);
-    }
+    // 连续按键、粘贴或一次操作内的多次更新，只在回到事件循环后刷新一次
+    display.scheduled = true;
+    QTimer::singleShot(0, this, &MainWindow::flushDisplays);
 }
 
-QString MainWindow::formatBinWithSpaces(const QString &bin)
+void MainWindow::flushDisplays()
 {
-    if (bin.isEmpty()) return bin;
-    
-    QString result;
-    // 从右到左每四位加一个空格
-    for (int i = bin.length() - 1; i >= 0; i--) {
-        if ((bin.length() - 1 - i) > 0 && (bin.length() - 1 - i) % 4 == 0) {
-            result.prepend(' ');
+    TRACE_SCOPE("flushDisplays");
+    display.scheduled = false;
+    uint dirty = display.dirty;
+    display.dirty = 0;
+    QVector<int> changedParts;
+    changedParts.swap(display.changedParts);
+    if (!display.valid || !dirty) return;
+
+    // 结果框需要整体刷新时一次生成所有显示文本（没有分割时结果框显示原始值）；
+    // 否则只生成四个数值框，结果框逐段编辑后只重写值变化的段，段数再多也只格式化改动的那几段
+    const bool splitDirty = dirty & SplitFields;
+    if (splitDirty) {
+        calc::formatDisplay(display.value, display.valueBits, splitLayout, displayStrings);
+    } else {
+        calc::formatValues(display.value, display.valueBits, displayStrings);
+    }
+
+    // 写入时产生的 textChanged 不再回流到输入处理
+    const bool wasUpdating = isUpdating;
+    isUpdating = true;
+
+    if (dirty & FieldDec) setFieldText(ui->editDec, displayStrings.dec);
+    if (dirty & FieldHex) setFieldText(ui->editHex, displayStrings.hex);
+    if (dirty & FieldOct) setFieldText(ui->editOct, displayStrings.oct);
+    if (dirty & FieldBin) setFieldText(ui->editBin, displayStrings.bin);
+
+    if (!splitDirty && !changedParts.isEmpty()) {
+        // 框内段数与布局不符（如正在输入 '|'）时退回整框重写
+        bool replaced = setChangedSplitFields(ui->editBinResult, BIN, changedParts);
+        replaced = setChangedSplitFields(ui->editDecResult, DEC, changedParts) && replaced;
+        replaced = setChangedSplitFields(ui->editHexResult, HEX, changedParts) && replaced;
+        if (!replaced) {
+            calc::formatDisplay(display.value, display.valueBits, splitLayout, displayStrings);
+            dirty |= SplitFields;
         }
-        result.prepend(bin[i]);
     }
-    return result;
+    if (dirty & FieldBinResult) setFieldText(ui->editBinResult, displayStrings.binSplit);
+    if (dirty & FieldDecResult) setFieldText(ui->editDecResult, displayStrings.decSplit);
+    if (dirty & FieldHexResult) setFieldText(ui->editHexResult, displayStrings.hexSplit);
+
+    if (dirty & FieldExpression) {
+        const QString *text = &displayStrings.dec;
+        if (display.expressionBase == HEX) text = &displayStrings.hex;
+        else if (display.expressionBase == OCT) text = &displayStrings.oct;
+        else if (display.expressionBase == BIN) text = &displayStrings.bin;
+        setFieldText(ui->editExpression, *text);
+    }
+
+    // 数值或位宽变化后，引用 x 的预览结果随之变化
+    if (dirty & ValueFields) updatePreview();
+
+    isUpdating = wasUpdating;
 }
 
-QString MainWindow::formatBinWithSplit(const QString &bin, const QString &rule)
+void MainWindow::setFieldText(QLineEdit *edit, const QString &text)
 {
-    if (rule.isEmpty() || bin.isEmpty()) return bin;
-
-    // 1. 解析规则并计算规则要求的总长度
-    QStringList ruleStrings = rule.split(',');
-    QList<int> lens;
-    int totalRuleLen = 0;
-    for (const QString& s : ruleStrings) {
-        bool ok;
-        int l = s.trimmed().toInt(&ok);
-        if (ok && l > 0) {
-            lens << l;
-            totalRuleLen += l;
-        }
-    }
+    if (edit->text() == text) return;
 
-    if (lens.isEmpty()) return bin;
+    // setText 会把光标移到末尾，写入后恢复到原来的位置
+    const int savedPos = edit->cursorPosition();
+    edit->setText(text);
+    edit->setCursorPosition(qMin(savedPos, text.length()));
+}
 
-    // 2. 补0逻辑：如果原始二进制长度不足规则总长，在高位（左侧）补0
-    QString paddedBin = bin;
-    if (bin.length() < totalRuleLen) {
-        paddedBin = bin.rightJustified(totalRuleLen, '0');
+bool MainWindow::setChangedSplitFields(QLineEdit *edit, int base, const QVector<int> &parts)
+{
+    const int valueBits = calc::bitLength(display.value, display.valueBits);
+    const int count = splitLayout.fieldCount(valueBits);
+
+    // 各段在框内的起点，段间以 '|' 分隔
+    QString text = edit->text();
+    QVarLengthArray<int, 64> starts;
+    starts.append(0);
+    for (int i = 0; i < text.size(); ++i) {
+        if (text[i] == QLatin1Char('|')) starts.append(i + 1);
     }
-
-    QStringList resultParts;
-    int currentLen = paddedBin.length();
-    int currentPos = 0;
-
-    // 3. 计算"规则外"的高位部分
-    // 如果 paddedBin 比 totalRuleLen 长（即用户规则只定义了低位的一部分），多出的高位作为第一段
-    int remainderLen = currentLen - totalRuleLen;
-    if (remainderLen > 0) {
-        QString firstSegment = paddedBin.left(remainderLen);
-        // 对第一段内部添加空格格式化
-        resultParts << formatBinWithSpaces(firstSegment);
-        currentPos = remainderLen;
+    if (starts.size() != count) return false;
+
+    // 从右往左替换，左边各段的起点不受影响
+    for (int i = parts.size() - 1; i >= 0; --i) {
+        const int index = parts[i];
+        const int start = starts[index];
+        const int end = index + 1 < count ? starts[index + 1] - 1 : text.size();
+        text.replace(start, end - start,
+                     calc::formatSplitField(display.value, splitLayout.field(index, valueBits), base));
     }
+    setFieldText(edit, text);
+    return true;
+}
 
-    // 4. 按照规则从高位向低位依次切分
-    // 此时由于已经补过0，规则定义的每一段都能取满
-    for (int l : lens) {
-        if (currentPos >= currentLen) break;
-        QString segment = paddedBin.mid(currentPos, l);
-        // 对每段内部添加空格格式化
-        resultParts << formatBinWithSpaces(segment);
-        currentPos += l;
-    }
+QString MainWindow::formatBinWithSpaces(const QString &bin)
+{
+    return calc::formatBinWithSpaces(bin);
+}
 
-    return resultParts.join('|');
+QString MainWindow::formatBinWithSplit(long long value)
+{
+    TRACE_SCOPE("formatBinWithSplit");
+    return calc::formatBinWithSplit(quint64(value), splitLayout);
 }
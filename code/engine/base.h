@@ -0,0 +1,11 @@
+#ifndef BASE_H
+#define BASE_H
+
+namespace calc {
+
+// 进制，数值即基数，与 MainWindow::Base 一一对应
+enum Base { BIN = 2, OCT = 8, DEC = 10, HEX = 16 };
+
+} // namespace calc
+
+#endif // BASE_H
@@ -0,0 +1,180 @@
+#include "bitfield.h"
+#include "cpufeatures.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#  define CALC_X86_64 1
+#  include <immintrin.h>
+#endif
+
+// GCC/Clang 需要按函数开启指令集，MSVC 直接可用内建函数
+#if defined(__GNUC__) || defined(__clang__)
+#  define CALC_TARGET(isa) __attribute__((target(isa)))
+#else
+#  define CALC_TARGET(isa)
+#endif
+
+namespace calc {
+
+namespace {
+
+typedef quint64 (*BitsFunction)(quint64 a, quint64 mask);
+typedef void (*ExtractKernel)(const quint64 *in, quint64 *out, qsizetype count, quint64 mask);
+typedef void (*DepositKernel)(const quint64 *fields, quint64 *values, qsizetype count, quint64 mask);
+
+struct BitFieldKernels
+{
+    const char *name;
+    BitsFunction extract;
+    BitsFunction deposit;
+    ExtractKernel extractColumn;
+    DepositKernel depositColumn;
+};
+
+inline int lowestBit(quint64 mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(mask);
+#else
+    int n = 0;
+    while (!(mask & 1)) { mask >>= 1; ++n; }
+    return n;
+#endif
+}
+
+// 掩码是否为一段连续的 1（非 0）
+inline bool isContiguous(quint64 mask)
+{
+    const quint64 m = mask >> lowestBit(mask);
+    return (m & (m + 1)) == 0;
+}
+
+// -------------------------------
+// 通用实现
+// -------------------------------
+quint64 portableExtract(quint64 value, quint64 mask)
+{
+    if (!mask) return 0;
+    if (isContiguous(mask)) return (value & mask) >> lowestBit(mask);
+
+    quint64 result = 0;
+    quint64 bit = 1;
+    for (; mask; mask &= mask - 1, bit <<= 1) {
+        if (value & mask & (0 - mask)) result |= bit;
+    }
+    return result;
+}
+
+quint64 portableDeposit(quint64 bits, quint64 mask)
+{
+    if (!mask) return 0;
+    if (isContiguous(mask)) return (bits << lowestBit(mask)) & mask;
+
+    quint64 result = 0;
+    for (; mask; mask &= mask - 1, bits >>= 1) {
+        if (bits & 1) result |= mask & (0 - mask);
+    }
+    return result;
+}
+
+void portableExtractColumn(const quint64 *in, quint64 *out, qsizetype count, quint64 mask)
+{
+    // 连续字段（分割规则的常见情况）在循环外判断一次，循环体只剩移位与掩码
+    if (mask && isContiguous(mask)) {
+        const int shift = lowestBit(mask);
+        for (qsizetype i = 0; i < count; ++i) out[i] = (in[i] & mask) >> shift;
+    } else {
+        for (qsizetype i = 0; i < count; ++i) out[i] = portableExtract(in[i], mask);
+    }
+}
+
+void portableDepositColumn(const quint64 *fields, quint64 *values, qsizetype count, quint64 mask)
+{
+    if (mask && isContiguous(mask)) {
+        const int shift = lowestBit(mask);
+        for (qsizetype i = 0; i < count; ++i)
+            values[i] = (values[i] & ~mask) | ((fields[i] << shift) & mask);
+    } else {
+        for (qsizetype i = 0; i < count; ++i)
+            values[i] = (values[i] & ~mask) | portableDeposit(fields[i], mask);
+    }
+}
+
+// -------------------------------
+// BMI2 实现
+// -------------------------------
+#ifdef CALC_X86_64
+CALC_TARGET("bmi2") quint64 bmi2Extract(quint64 value, quint64 mask)
+{
+    return _pext_u64(value, mask);
+}
+
+CALC_TARGET("bmi2") quint64 bmi2Deposit(quint64 bits, quint64 mask)
+{
+    return _pdep_u64(bits, mask);
+}
+
+// 连续字段走与通用实现相同的移位路径（比 pext/pdep 更快），只有非连续掩码才用 BMI2
+CALC_TARGET("bmi2") void bmi2ExtractColumn(const quint64 *in, quint64 *out, qsizetype count, quint64 mask)
+{
+    if (!mask || isContiguous(mask)) {
+        portableExtractColumn(in, out, count, mask);
+        return;
+    }
+    for (qsizetype i = 0; i < count; ++i) out[i] = _pext_u64(in[i], mask);
+}
+
+CALC_TARGET("bmi2") void bmi2DepositColumn(const quint64 *fields, quint64 *values, qsizetype count, quint64 mask)
+{
+    if (!mask || isContiguous(mask)) {
+        portableDepositColumn(fields, values, count, mask);
+        return;
+    }
+    for (qsizetype i = 0; i < count; ++i)
+        values[i] = (values[i] & ~mask) | _pdep_u64(fields[i], mask);
+}
+#endif // CALC_X86_64
+
+BitFieldKernels selectKernels()
+{
+#ifdef CALC_X86_64
+    // Zen3 之前的 AMD 上 pext/pdep 为微码实现，比通用的逐位循环还慢
+    if (cpuFeatures().fastBmi2)
+        return { "bmi2", bmi2Extract, bmi2Deposit, bmi2ExtractColumn, bmi2DepositColumn };
+#endif
+    return { "portable", portableExtract, portableDeposit, portableExtractColumn, portableDepositColumn };
+}
+
+const BitFieldKernels &kernels()
+{
+    static const BitFieldKernels selected = selectKernels();
+    return selected;
+}
+
+} // namespace
+
+quint64 extractBits(quint64 value, quint64 mask)
+{
+    return kernels().extract(value, mask);
+}
+
+quint64 depositBits(quint64 bits, quint64 mask)
+{
+    return kernels().deposit(bits, mask);
+}
+
+void extractColumn(const quint64 *in, quint64 *out, qsizetype count, quint64 mask)
+{
+    if (count > 0) kernels().extractColumn(in, out, count, mask);
+}
+
+void depositColumn(const quint64 *fields, quint64 *values, qsizetype count, quint64 mask)
+{
+    if (count > 0) kernels().depositColumn(fields, values, count, mask);
+}
+
+const char *bitFieldKernelName()
+{
+    return kernels().name;
+}
+
+} // namespace calc
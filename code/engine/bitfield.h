@@ -0,0 +1,30 @@
+#ifndef BITFIELD_H
+#define BITFIELD_H
+
+#include <QtGlobal>
+
+namespace calc {
+
+// -------------------------------
+// 按掩码提取 / 写入位字段，掩码可以不连续
+// 支持 BMI2 时使用 pext/pdep，否则用移位与掩码（连续字段）或逐位循环，运行时选择
+// -------------------------------
+
+// 收集 value 中 mask 为 1 的各位，依次放到结果的低位（pext）
+quint64 extractBits(quint64 value, quint64 mask);
+
+// 把 bits 的低位依次放到 mask 为 1 的各位上，其余位为 0（pdep）
+quint64 depositBits(quint64 bits, quint64 mask);
+
+// 批量提取：out[i] = extractBits(in[i], mask)，in 与 out 可以是同一块内存
+void extractColumn(const quint64 *in, quint64 *out, qsizetype count, quint64 mask);
+
+// 批量写入：values[i] 中 mask 指定的位替换为 fields[i] 的低位
+void depositColumn(const quint64 *fields, quint64 *values, qsizetype count, quint64 mask);
+
+// 当前选用的实现："bmi2" 或 "portable"
+const char *bitFieldKernelName();
+
+} // namespace calc
+
+#endif // BITFIELD_H
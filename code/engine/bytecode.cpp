@@ -0,0 +1,244 @@
+#include "bytecode.h"
+#include "ops.h"
+#include "tokenizer.h"
+
+#include <QVarLengthArray>
+
+namespace calc {
+
+namespace {
+
+OpCode binaryOpCode(TokenKind kind)
+{
+    switch(kind) {
+    case TokPlus: return OpAdd;
+    case TokMinus: return OpSub;
+    case TokStar: return OpMul;
+    case TokSlash: return OpDiv;
+    case TokPercent: return OpMod;
+    case TokAmp: return OpAnd;
+    case TokPipe: return OpOr;
+    case TokCaret: return OpXor;
+    case TokShl: return OpShl;
+    default: return OpShr;
+    }
+}
+
+// -------------------------------
+// 优先级爬升解析器：边解析边按后缀顺序发射字节码
+// 前缀运算符 - ~ + 结合最紧，双目运算符均为左结合
+// -------------------------------
+class Parser
+{
+public:
+    Parser(QStringView expr, int base, Program &program)
+        : text(expr), tokenizer(expr, base), program(program), base(base), depth(0) {}
+
+    bool parse()
+    {
+        advance();
+        if(!parseExpression(0, 0)) return false;
+        if(current.kind != TokEnd) return fail();
+        return true;
+    }
+
+private:
+    void advance() { current = tokenizer.next(); }
+
+    bool fail()
+    {
+        program.errorColumn = current.pos;
+        return false;
+    }
+
+    void emit(OpCode op, int stackDelta)
+    {
+        program.code.append(op);
+        depth += stackDelta;
+        if(depth > program.maxDepth) program.maxDepth = depth;
+    }
+
+    bool parseExpression(int minPrecedence, int nesting)
+    {
+        if(!parsePrefix(nesting)) return false;
+        for(;;) {
+            const int precedence = binaryPrecedence(current.kind);
+            if(precedence < minPrecedence) return true;
+            const OpCode op = binaryOpCode(current.kind);
+            advance();
+            if(!parseExpression(precedence + 1, nesting)) return false;
+            emit(op, -1);
+        }
+    }
+
+    bool parsePrefix(int nesting)
+    {
+        if(nesting > MaxNesting) return fail();
+
+        switch(current.kind) {
+        case TokNumber:
+            program.imms.append(current.value);
+            if(program.valueBits > 64) appendWideImmediate();
+            emit(OpPush, 1);
+            advance();
+            return true;
+        case TokVar:
+            program.usesVariable = true;
+            emit(OpVar, 1);
+            advance();
+            return true;
+        case TokLParen:
+            advance();
+            if(!parseExpression(0, nesting + 1)) return false;
+            if(current.kind != TokRParen) return fail();
+            advance();
+            return true;
+        case TokMinus:
+        case TokTilde:
+        case TokPlus: {
+            const TokenKind kind = current.kind;
+            advance();
+            if(!parsePrefix(nesting + 1)) return false;
+            if(kind == TokMinus) emit(OpNeg, 0);
+            else if(kind == TokTilde) emit(OpNot, 0);
+            return true;
+        }
+        default:
+            return fail();
+        }
+    }
+
+    // 按程序的位宽重新累加当前字面量（数字已由词法分析确认），超出有符号范围时取 0，与 64 位一致
+    void appendWideImmediate()
+    {
+        const int limbCount = program.valueBits / 64;
+        quint64 value[MaxValueBits / 64] = {};
+        bool overflow = false;
+        const QStringView digits = text.mid(current.pos, current.length);
+        for(QChar c : digits) {
+            if(c.isSpace()) continue;
+            const ushort u = c.unicode();
+            const int digit = u <= '9' ? u - '0' : (u | 0x20) - 'a' + 10;
+            if(limbs::mulAdd(value, limbCount, quint64(base), quint64(digit))) overflow = true;
+        }
+        if(qint64(value[limbCount - 1]) < 0) overflow = true;
+        for(int i = 0; i < limbCount; ++i) program.wideImms.append(overflow ? 0 : value[i]);
+    }
+
+    QStringView text;
+    Tokenizer tokenizer;
+    Token current;
+    Program &program;
+    int base;
+    int depth;  // 当前值栈深度
+};
+
+} // namespace
+
+Program compile(const QString &expr, int base, int valueBits)
+{
+    Program program;
+    compile(QStringView(expr), base, valueBits, program);
+    return program;
+}
+
+void compile(QStringView expr, int base, int valueBits, Program &program)
+{
+    program.valueBits = isValueBits(valueBits) ? valueBits : 64;
+    program.maxDepth = 0;
+    program.usesVariable = false;
+    program.errorColumn = -1;
+    program.code.resize(0);
+    program.imms.resize(0);
+    program.wideImms.resize(0);
+
+    // 指令数不超过字符数，立即数之间至少隔一个运算符，预留一次即可
+    const int size = int(expr.size());
+    program.code.reserve(size);
+    program.imms.reserve((size + 1) / 2);
+    if(program.valueBits > 64) program.wideImms.reserve((size + 1) / 2 * (program.valueBits / 64));
+
+    Parser parser(expr, base, program);
+    if(!parser.parse()) {
+        program.maxDepth = 0;
+        program.usesVariable = false;
+        program.code.resize(0);
+        program.imms.resize(0);
+        program.wideImms.resize(0);
+    }
+}
+
+namespace {
+
+// 64 位与宽整数共用的解释循环，运算经 ops 按 Int 的位宽选择实现
+template<typename Int>
+Int run(const Program &program, const Int &x, const Int *imm)
+{
+    QVarLengthArray<Int, 32> stack(program.maxDepth);
+    Int *const bottom = stack.data();
+    Int *sp = bottom; // 指向下一个空位
+
+    const quint8 *pc = program.code.constData();
+    const quint8 *const end = pc + program.code.size();
+
+    while(pc != end) {
+        switch(*pc++) {
+        case OpPush: *sp++ = *imm++; break;
+        case OpVar:  *sp++ = x; break;
+        case OpAdd:  sp[-2] = ops::add(sp[-2], sp[-1]); --sp; break;
+        case OpSub:  sp[-2] = ops::sub(sp[-2], sp[-1]); --sp; break;
+        case OpMul:  sp[-2] = ops::mul(sp[-2], sp[-1]); --sp; break;
+        case OpDiv:  sp[-2] = ops::div(sp[-2], sp[-1]); --sp; break;
+        case OpMod:  sp[-2] = ops::mod(sp[-2], sp[-1]); --sp; break;
+        case OpAnd:  sp[-2] &= sp[-1]; --sp; break;
+        case OpOr:   sp[-2] |= sp[-1]; --sp; break;
+        case OpXor:  sp[-2] ^= sp[-1]; --sp; break;
+        case OpShl:  sp[-2] = ops::shl(sp[-2], sp[-1]); --sp; break;
+        case OpShr:  sp[-2] = ops::shr(sp[-2], sp[-1]); --sp; break;
+        case OpNeg:  sp[-1] = ops::neg(sp[-1]); break;
+        case OpNot:  sp[-1] = ~sp[-1]; break;
+        }
+    }
+
+    return sp == bottom ? Int() : sp[-1];
+}
+
+} // namespace
+
+qint64 execute(const Program &program, qint64 x)
+{
+    return run(program, x, program.imms.constData());
+}
+
+template<int Bits>
+WideInt<Bits> execute(const Program &program, const WideInt<Bits> &x)
+{
+    if(Bits == 64) return WideInt<Bits>::fromInt64(execute(program, qint64(x.limb[0])));
+    if(program.valueBits != Bits) return WideInt<Bits>();
+    return run(program, x, reinterpret_cast<const WideInt<Bits> *>(program.wideImms.constData()));
+}
+
+template WideInt<64> execute<64>(const Program &, const WideInt<64> &);
+template WideInt<128> execute<128>(const Program &, const WideInt<128> &);
+template WideInt<256> execute<256>(const Program &, const WideInt<256> &);
+template WideInt<512> execute<512>(const Program &, const WideInt<512> &);
+
+// -------------------------------
+// 编译结果缓存
+// -------------------------------
+const Program &ProgramCache::get(const QString &expr, int base, int valueBits)
+{
+    const QPair<QString, QPair<int, int>> key(expr, qMakePair(base, valueBits));
+    auto it = programs.constFind(key);
+    if(it != programs.constEnd()) return it.value();
+
+    if(programs.size() >= MaxEntries) programs.clear();
+    return programs.insert(key, compile(expr, base, valueBits)).value();
+}
+
+void ProgramCache::clear()
+{
+    programs.clear();
+}
+
+} // namespace calc
@@ -0,0 +1,75 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <QHash>
+#include <QPair>
+#include <QString>
+#include <QStringView>
+#include <QVector>
+
+#include "base.h"
+#include "wideint.h"
+
+namespace calc {
+
+// -------------------------------
+// 字节码操作码（后缀程序，栈式执行）
+// -------------------------------
+enum OpCode : quint8 {
+    OpPush,                          // 压入下一个立即数
+    OpVar,                           // 压入变量 x
+    OpAdd, OpSub, OpMul, OpDiv, OpMod,
+    OpAnd, OpOr, OpXor, OpShl, OpShr,
+    OpNeg, OpNot                     // 单目运算符
+};
+
+// 编译后的表达式：操作码序列 + 按顺序被 OpPush 消费的立即数
+struct Program
+{
+    QVector<quint8> code;
+    QVector<qint64> imms;
+    QVector<quint64> wideImms; // 位宽超过 64 时按位宽存放的立即数，每个 valueBits / 64 块、低位在前
+    int valueBits = 64;        // 编译时的数值位宽
+    int maxDepth = 0;          // 执行所需的最大栈深度
+    bool usesVariable = false; // 是否引用了变量 x
+    int errorColumn = -1;      // 语法错误所在的字符下标，-1 表示编译成功
+
+    bool ok() const { return errorColumn < 0; }
+};
+
+// 括号与前缀运算符的最大嵌套层数，防止递归过深
+const int MaxNesting = 256;
+
+// 将表达式按指定进制（Base）编译为后缀程序；语法错误时返回空程序并记录出错位置
+// valueBits 为 128/256/512 时另按该位宽解析立即数，供宽整数执行
+Program compile(const QString &expr, int base, int valueBits = 64);
+
+// 同上，但编译到已有的 program 中：先清空各数组（保留容量，不释放）再写入
+// 反复用同一个 Program 编译时，它就是每次求值复用的缓冲区，容量够用后不再分配内存；
+// program 的数组与其他副本共享时仍会复制一次
+void compile(QStringView expr, int base, int valueBits, Program &program);
+
+// 执行后缀程序，不做任何字符串操作；x 为表达式中变量 x 的取值
+qint64 execute(const Program &program, qint64 x = 0);
+
+// 按 Bits 位补码执行以相同位宽编译的程序，位宽不符时返回 0；Bits 为 64 时即上面的原生执行
+template<int Bits> WideInt<Bits> execute(const Program &program, const WideInt<Bits> &x);
+
+// -------------------------------
+// 编译结果缓存：按 (表达式文本, 进制, 位宽) 复用已编译的程序
+// -------------------------------
+class ProgramCache
+{
+public:
+    const Program &get(const QString &expr, int base, int valueBits = 64);
+    void clear();
+
+private:
+    static const int MaxEntries = 256; // 超出后整体清空，避免无限增长
+
+    QHash<QPair<QString, QPair<int, int>>, Program> programs;
+};
+
+} // namespace calc
+
+#endif // BYTECODE_H
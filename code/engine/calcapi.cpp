@@ -0,0 +1,279 @@
+#include "calcapi.h"
+#include "bytecode.h"
+#include "column.h"
+#include "format.h"
+#include "radix.h"
+#include "splitlayout.h"
+#include "validator.h"
+
+#include <QVarLengthArray>
+
+#include <climits>
+#include <cstring>
+
+// 句柄只包装引擎对象，创建后不再修改，因此可以在线程间共享
+struct calc_program
+{
+    calc::Program program;
+};
+
+struct calc_split_layout
+{
+    calc::SplitLayout layout;
+};
+
+// 校验错误直接转换为 calc_status，两个枚举的对应项必须保持相同的数值
+static_assert(int(CALC_OK) == int(calc::NoError), "calc_status 与 ValidationError 不一致");
+static_assert(int(CALC_EMPTY_EXPRESSION) == int(calc::EmptyExpression), "calc_status 与 ValidationError 不一致");
+static_assert(int(CALC_TOO_MANY_RIGHT_PARENS) == int(calc::TooManyRightParens), "calc_status 与 ValidationError 不一致");
+static_assert(int(CALC_TOO_MANY_LEFT_PARENS) == int(calc::TooManyLeftParens), "calc_status 与 ValidationError 不一致");
+static_assert(int(CALC_ILLEGAL_CHARACTER) == int(calc::IllegalCharacter), "calc_status 与 ValidationError 不一致");
+static_assert(int(CALC_LEADING_OPERATOR) == int(calc::LeadingOperator), "calc_status 与 ValidationError 不一致");
+static_assert(int(CALC_CONSECUTIVE_OPERATORS) == int(calc::ConsecutiveOperators), "calc_status 与 ValidationError 不一致");
+static_assert(int(CALC_DIVISION_BY_ZERO) == int(calc::DivisionByZero), "calc_status 与 ValidationError 不一致");
+static_assert(int(CALC_TRAILING_OPERATOR) == int(calc::TrailingOperator), "calc_status 与 ValidationError 不一致");
+
+namespace {
+
+// calc_evaluate 在各线程中保留的程序缓冲区最多对应这么长的表达式，更长的用完即释放
+const size_t MaxRetainedChars = 4096;
+
+inline bool validBase(int base)
+{
+    return base == calc::BIN || base == calc::OCT || base == calc::DEC || base == calc::HEX;
+}
+
+inline void setPosition(size_t *pos, int column)
+{
+    if (pos) *pos = column < 0 ? 0 : size_t(column);
+}
+
+// 按 snprintf 的约定输出
+size_t copyOut(const char *data, size_t length, char *out, size_t size)
+{
+    if (out && length < size) {
+        memcpy(out, data, length);
+        out[length] = '\0';
+    }
+    return length;
+}
+
+// 校验通过的表达式只含 ASCII，按 Latin-1 转换与 UTF-8 一致，字节下标即字符下标
+calc_status compileExpression(const char *expr, size_t length, int base, calc::Program &program, size_t *errorPos)
+{
+    if ((!expr && length) || !validBase(base) || length > size_t(INT_MAX)) return CALC_INVALID_ARGUMENT;
+
+    const calc::Validation validation = calc::validate(QLatin1String(expr, int(length)), base);
+    if (!validation.ok()) {
+        setPosition(errorPos, validation.column);
+        return calc_status(validation.error);
+    }
+
+    // 在栈上转为 UTF-16，常见长度的表达式不分配内存
+    const int size = int(length);
+    QVarLengthArray<QChar, 256> text(size);
+    for (int i = 0; i < size; ++i) text[i] = QLatin1Char(expr[i]);
+    calc::compile(QStringView(text.constData(), text.size()), base, 64, program);
+    if (!program.ok()) {
+        setPosition(errorPos, program.errorColumn);
+        return CALC_SYNTAX_ERROR;
+    }
+    return CALC_OK;
+}
+
+// 逐段写入 '|' 分隔的文本；write(out, part, field) 写入一段并返回字符数，maxPart 为一段的最大字符数
+template<typename Write>
+size_t writeFields(quint64 value, const calc::SplitLayout &layout, int maxPart, char *out, size_t size, Write write)
+{
+    const int valueBits = calc::bitLength(value);
+    const int count = layout.fieldCount(valueBits);
+    QVarLengthArray<char, 256> text;
+    for (int i = 0; i < count; ++i) {
+        const calc::SplitField field = layout.field(i, valueBits);
+        const int start = text.size();
+        text.resize(start + (i > 0 ? 1 : 0) + maxPart);
+        char *p = text.data() + start;
+        if (i > 0) *p++ = '|';
+        const int written = write(p, calc::SplitLayout::extract(value, field), field);
+        text.resize(int(p - text.data()) + written);
+    }
+    return copyOut(text.constData(), size_t(text.size()), out, size);
+}
+
+} // namespace
+
+extern "C" {
+
+const char *calc_status_message(calc_status status)
+{
+    switch (status) {
+    case CALC_OK:                    return "";
+    case CALC_EMPTY_EXPRESSION:      return "表达式为空";
+    case CALC_TOO_MANY_RIGHT_PARENS: return "括号不匹配：右括号过多";
+    case CALC_TOO_MANY_LEFT_PARENS:  return "括号不匹配：左括号过多";
+    case CALC_ILLEGAL_CHARACTER:     return "表达式包含非法字符";
+    case CALC_LEADING_OPERATOR:      return "表达式不能以运算符开头";
+    case CALC_CONSECUTIVE_OPERATORS: return "表达式包含连续的运算符";
+    case CALC_DIVISION_BY_ZERO:      return "除数不得为0";
+    case CALC_TRAILING_OPERATOR:     return "表达式不能以运算符结尾";
+    case CALC_SYNTAX_ERROR:          return "表达式语法错误";
+    case CALC_INVALID_NUMBER:        return "无效的数值";
+    case CALC_NUMBER_OVERFLOW:       return "输入内容超出64位二进制数能表示的范围";
+    case CALC_SPLIT_MISMATCH:        return "段数与分割规则不符";
+    case CALC_INVALID_ARGUMENT:      return "无效的参数";
+    }
+    return "";
+}
+
+// -------------------------------
+// 表达式
+// -------------------------------
+calc_status calc_validate(const char *expr, size_t length, int base, size_t *error_pos)
+{
+    if ((!expr && length) || !validBase(base) || length > size_t(INT_MAX)) return CALC_INVALID_ARGUMENT;
+    const calc::Validation validation = calc::validate(QLatin1String(expr, int(length)), base);
+    if (!validation.ok()) setPosition(error_pos, validation.column);
+    return calc_status(validation.error);
+}
+
+calc_status calc_compile(const char *expr, size_t length, int base, calc_program **program, size_t *error_pos)
+{
+    if (!program) return CALC_INVALID_ARGUMENT;
+    *program = nullptr;
+
+    calc::Program compiled;
+    const calc_status status = compileExpression(expr, length, base, compiled, error_pos);
+    if (status == CALC_OK) *program = new calc_program{compiled};
+    return status;
+}
+
+void calc_program_free(calc_program *program)
+{
+    delete program;
+}
+
+int calc_program_uses_variable(const calc_program *program)
+{
+    return program && program->program.usesVariable;
+}
+
+int64_t calc_execute(const calc_program *program, int64_t x)
+{
+    return program ? calc::execute(program->program, x) : 0;
+}
+
+void calc_execute_column(const calc_program *program, const int64_t *in, int64_t *out, size_t count)
+{
+    if (!program || !in || !out) return;
+    calc::executeColumn(program->program, reinterpret_cast<const qint64 *>(in),
+                        reinterpret_cast<qint64 *>(out), qsizetype(count));
+}
+
+calc_status calc_evaluate(const char *expr, size_t length, int base, int64_t x, int64_t *result, size_t *error_pos)
+{
+    if (!result) return CALC_INVALID_ARGUMENT;
+    // 每个线程复用同一个程序的缓冲区，反复求值不再分配内存
+    thread_local calc::Program program;
+    const calc_status status = compileExpression(expr, length, base, program, error_pos);
+    if (status == CALC_OK) *result = calc::execute(program, x);
+    // 宿主线程的生命周期不由这里决定，偶尔的超长表达式不应让缓冲区一直占着
+    if (length > MaxRetainedChars) program = calc::Program();
+    return status;
+}
+
+// -------------------------------
+// 数值
+// -------------------------------
+calc_status calc_parse_number(const char *text, size_t length, int base, int64_t *value, size_t *error_pos)
+{
+    if ((!text && length) || !value || !validBase(base) || length > size_t(INT_MAX)) return CALC_INVALID_ARGUMENT;
+
+    const calc::ParsedNumber parsed = calc::parseNumber(text, int(length), base);
+    if (parsed.errorPos >= 0) {
+        setPosition(error_pos, parsed.errorPos);
+        return CALC_INVALID_NUMBER;
+    }
+    if (parsed.empty) return CALC_INVALID_NUMBER;
+    if (parsed.overflow) return CALC_NUMBER_OVERFLOW;
+    *value = int64_t(parsed.value);
+    return CALC_OK;
+}
+
+size_t calc_format_number(int64_t value, int base, char *out, size_t size)
+{
+    if (!validBase(base)) return 0;
+    char buffer[calc::MaxNumberChars];
+    return copyOut(buffer, size_t(calc::formatNumber(buffer, value, base)), out, size);
+}
+
+size_t calc_format_bin_grouped(uint64_t value, char *out, size_t size)
+{
+    char buffer[calc::MaxNumberChars];
+    return copyOut(buffer, size_t(calc::formatBinField(buffer, value, calc::bitLength(value), true)), out, size);
+}
+
+// -------------------------------
+// 分割规则
+// -------------------------------
+calc_split_layout *calc_split_layout_new(const char *rule, size_t length)
+{
+    if ((!rule && length) || length > size_t(INT_MAX)) return nullptr;
+    const QString text = QString::fromUtf8(rule, int(length));
+    return new calc_split_layout{calc::SplitLayout(QStringView(text))};
+}
+
+void calc_split_layout_free(calc_split_layout *layout)
+{
+    delete layout;
+}
+
+int calc_split_layout_total_bits(const calc_split_layout *layout)
+{
+    return layout ? layout->layout.totalBits() : 0;
+}
+
+size_t calc_format_bin_split(uint64_t value, const calc_split_layout *layout, char *out, size_t size)
+{
+    if (!layout || layout->layout.isEmpty()) {
+        char buffer[calc::MaxNumberChars];
+        return copyOut(buffer, size_t(calc::formatUnsigned(buffer, value, calc::BIN)), out, size);
+    }
+
+    // 段宽可超过 64 位（高位补 0），按该段实际位宽预留
+    int maxPart = 0;
+    const int valueBits = calc::bitLength(value);
+    for (int i = 0; i < layout->layout.fieldCount(valueBits); ++i) {
+        maxPart = qMax(maxPart, calc::binFieldLength(layout->layout.field(i, valueBits).width, true));
+    }
+    return writeFields(value, layout->layout, maxPart, out, size,
+                       [](char *p, quint64 part, const calc::SplitField &field) {
+        return calc::formatBinField(p, part, field.width, true);
+    });
+}
+
+size_t calc_format_split_parts(uint64_t value, const calc_split_layout *layout, int base, char *out, size_t size)
+{
+    if (!layout || !validBase(base)) return 0;
+    return writeFields(value, layout->layout, calc::MaxNumberChars, out, size,
+                       [base](char *p, quint64 part, const calc::SplitField &) {
+        return calc::formatUnsigned(p, part, base);
+    });
+}
+
+calc_status calc_parse_split_parts(const char *text, size_t length, const calc_split_layout *layout,
+                                   uint64_t reference, int base, uint64_t *value)
+{
+    if ((!text && length) || !layout || !value || !validBase(base) || length > size_t(INT_MAX)) {
+        return CALC_INVALID_ARGUMENT;
+    }
+
+    const QString parts = QString::fromUtf8(text, int(length));
+    quint64 result = 0;
+    if (!calc::parseSplitParts(QStringView(parts), layout->layout, calc::bitLength(reference), base, result)) {
+        return CALC_SPLIT_MISMATCH;
+    }
+    *value = result;
+    return CALC_OK;
+}
+
+} // extern "C"
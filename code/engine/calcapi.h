@@ -0,0 +1,113 @@
+#ifndef CALCAPI_H
+#define CALCAPI_H
+
+/*
+ * 计算引擎的 C 接口，供 C / Python（ctypes、cffi）等工具直接链接 calcengine 静态库
+ *
+ * - 所有函数都可重入，可以同时从多个线程调用；库内没有可变的全局状态
+ * - calc_program / calc_split_layout 创建后只读，可在线程间共享；释放前须确保没有线程仍在使用
+ * - 文本一律为 UTF-8，以 (指针, 字节数) 传入，不要求以 '\0' 结尾
+ * - 格式化函数与 snprintf 约定相同：返回完整结果的字节数（不含 '\0'），
+ *   size 足够时写入结果并补 '\0'，不足时不写入
+ * - 错误位置为出错字符在输入中的字节下标
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 进制，数值即基数 */
+enum {
+    CALC_BIN = 2,
+    CALC_OCT = 8,
+    CALC_DEC = 10,
+    CALC_HEX = 16
+};
+
+/* 返回状态，前几项与 calc::ValidationError 一一对应（calcapi.cpp 中有 static_assert 检查） */
+typedef enum calc_status {
+    CALC_OK = 0,
+    CALC_EMPTY_EXPRESSION,
+    CALC_TOO_MANY_RIGHT_PARENS,
+    CALC_TOO_MANY_LEFT_PARENS,
+    CALC_ILLEGAL_CHARACTER,
+    CALC_LEADING_OPERATOR,
+    CALC_CONSECUTIVE_OPERATORS,
+    CALC_DIVISION_BY_ZERO,
+    CALC_TRAILING_OPERATOR,
+    CALC_SYNTAX_ERROR,       /* 字符层面合法但语法错误，如 "3-*4" */
+    CALC_INVALID_NUMBER,     /* 数值文本含非法字符或为空 */
+    CALC_NUMBER_OVERFLOW,    /* 数值超出 64 位（带符号十进制超出 int64 范围） */
+    CALC_SPLIT_MISMATCH,     /* 分割规则为空或段数与规则不符 */
+    CALC_INVALID_ARGUMENT    /* 空指针或不支持的进制 */
+} calc_status;
+
+typedef struct calc_program calc_program;
+typedef struct calc_split_layout calc_split_layout;
+
+/* 状态对应的提示文本（UTF-8，静态存储） */
+const char *calc_status_message(calc_status status);
+
+/* -------- 表达式 -------- */
+
+/* 校验表达式；出错时 error_pos（可为 NULL）返回出错位置 */
+calc_status calc_validate(const char *expr, size_t length, int base, size_t *error_pos);
+
+/* 校验并编译表达式，成功时 *program 为新建的程序，用 calc_program_free 释放 */
+calc_status calc_compile(const char *expr, size_t length, int base, calc_program **program, size_t *error_pos);
+void calc_program_free(calc_program *program);
+
+/* 程序是否引用了变量 x */
+int calc_program_uses_variable(const calc_program *program);
+
+/* 执行程序；x 为变量 x 的取值，运算按 64 位补码回绕，除数为 0 时结果为 0 */
+int64_t calc_execute(const calc_program *program, int64_t x);
+
+/* 列式执行：out[i] = program(x = in[i])，in 与 out 可以相同 */
+void calc_execute_column(const calc_program *program, const int64_t *in, int64_t *out, size_t count);
+
+/* 一次完成校验、编译和执行；各线程复用内部的缓冲区，不超过 256 个字符的表达式不分配内存
+ * 缓冲区随线程保留，最多对应 4096 个字符的表达式；更长的表达式用完即释放 */
+calc_status calc_evaluate(const char *expr, size_t length, int base, int64_t x, int64_t *result, size_t *error_pos);
+
+/* -------- 数值 -------- */
+
+/* 解析数值文本，跳过分组字符 ' ' 和 '|'；十进制允许负号并按 int64 范围检查，其余进制按 64 位补码 */
+calc_status calc_parse_number(const char *text, size_t length, int base, int64_t *value, size_t *error_pos);
+
+/* 界面显示规则：十进制带符号，其余进制按 64 位补码，十六进制大写 */
+size_t calc_format_number(int64_t value, int base, char *out, size_t size);
+
+/* 二进制，从低位起每四位一个空格 */
+size_t calc_format_bin_grouped(uint64_t value, char *out, size_t size);
+
+/* -------- 分割规则 -------- */
+
+/* 解析分割规则（如 "1,2,4"，从高位应用），忽略无效段；用 calc_split_layout_free 释放 */
+calc_split_layout *calc_split_layout_new(const char *rule, size_t length);
+void calc_split_layout_free(calc_split_layout *layout);
+
+/* 规则描述的总位数，空规则为 0 */
+int calc_split_layout_total_bits(const calc_split_layout *layout);
+
+/* 按规则切分二进制，段内每四位一个空格，段间以 '|' 分隔；规则为空时为不带空格的二进制 */
+size_t calc_format_bin_split(uint64_t value, const calc_split_layout *layout, char *out, size_t size);
+
+/* 按规则逐段转换为指定进制，段间以 '|' 分隔 */
+size_t calc_format_split_parts(uint64_t value, const calc_split_layout *layout, int base, char *out, size_t size);
+
+/*
+ * 把以 '|' 分隔、高位在前的各段文本写回一个数值（calc_format_split_parts 的逆过程）
+ * reference 为当前数值，决定高位剩余段的宽度
+ */
+calc_status calc_parse_split_parts(const char *text, size_t length, const calc_split_layout *layout,
+                                   uint64_t reference, int base, uint64_t *value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CALCAPI_H */
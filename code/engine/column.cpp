@@ -0,0 +1,328 @@
+#include "column.h"
+#include "cpufeatures.h"
+#include "ops.h"
+
+#include <QVarLengthArray>
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#  define CALC_X86 1
+#  include <immintrin.h>
+#endif
+
+// GCC/Clang 需要按函数开启指令集，MSVC 直接可用内建函数
+#if defined(__GNUC__) || defined(__clang__)
+#  define CALC_TARGET(isa) __attribute__((target(isa)))
+#else
+#  define CALC_TARGET(isa)
+#endif
+
+namespace calc {
+
+namespace {
+
+// 每个栈槽 512 个元素（4KB），常见深度下整块工作集留在 L1/L2 中
+const int BlockSize = 512;
+
+typedef void (*BinaryKernel)(qint64 *a, const qint64 *b, int n);   // a[i] = a[i] op b[i]
+typedef void (*ScalarKernel)(qint64 *a, qint64 b, int n);          // a[i] = a[i] op b
+typedef void (*UnaryKernel)(qint64 *a, int n);                     // a[i] = op a[i]
+
+struct Kernels
+{
+    const char *name;
+    BinaryKernel binary[OpNot + 1];
+    ScalarKernel scalar[OpNot + 1];
+    UnaryKernel unary[OpNot + 1];
+};
+
+inline bool isBinary(quint8 op) { return op >= OpAdd && op <= OpShr; }
+
+inline qint64 bitAnd(qint64 a, qint64 b) { return a & b; }
+inline qint64 bitOr(qint64 a, qint64 b) { return a | b; }
+inline qint64 bitXor(qint64 a, qint64 b) { return a ^ b; }
+inline qint64 bitNot(qint64 a) { return ~a; }
+
+// -------------------------------
+// 标量内核（兜底，也用于乘除取模）
+// -------------------------------
+template<qint64 (*Op)(qint64, qint64)>
+void scalarBinary(qint64 *a, const qint64 *b, int n)
+{
+    for (int i = 0; i < n; ++i) a[i] = Op(a[i], b[i]);
+}
+
+template<qint64 (*Op)(qint64, qint64)>
+void scalarScalar(qint64 *a, qint64 b, int n)
+{
+    for (int i = 0; i < n; ++i) a[i] = Op(a[i], b);
+}
+
+template<qint64 (*Op)(qint64)>
+void scalarUnary(qint64 *a, int n)
+{
+    for (int i = 0; i < n; ++i) a[i] = Op(a[i]);
+}
+
+Kernels makeScalarKernels()
+{
+    Kernels k = {};
+    k.name = "scalar";
+
+    k.binary[OpAdd] = scalarBinary<ops::add>;
+    k.binary[OpSub] = scalarBinary<ops::sub>;
+    k.binary[OpMul] = scalarBinary<ops::mul>;
+    k.binary[OpDiv] = scalarBinary<ops::div>;
+    k.binary[OpMod] = scalarBinary<ops::mod>;
+    k.binary[OpAnd] = scalarBinary<bitAnd>;
+    k.binary[OpOr]  = scalarBinary<bitOr>;
+    k.binary[OpXor] = scalarBinary<bitXor>;
+    k.binary[OpShl] = scalarBinary<ops::shl>;
+    k.binary[OpShr] = scalarBinary<ops::shr>;
+
+    k.scalar[OpAdd] = scalarScalar<ops::add>;
+    k.scalar[OpSub] = scalarScalar<ops::sub>;
+    k.scalar[OpMul] = scalarScalar<ops::mul>;
+    k.scalar[OpDiv] = scalarScalar<ops::div>;
+    k.scalar[OpMod] = scalarScalar<ops::mod>;
+    k.scalar[OpAnd] = scalarScalar<bitAnd>;
+    k.scalar[OpOr]  = scalarScalar<bitOr>;
+    k.scalar[OpXor] = scalarScalar<bitXor>;
+    k.scalar[OpShl] = scalarScalar<ops::shl>;
+    k.scalar[OpShr] = scalarScalar<ops::shr>;
+
+    k.unary[OpNeg] = scalarUnary<ops::neg>;
+    k.unary[OpNot] = scalarUnary<bitNot>;
+    return k;
+}
+
+#ifdef CALC_X86
+// -------------------------------
+// AVX2 内核：每次 4 个元素，n 已按 8 对齐
+// -------------------------------
+// AVX2 没有 64 位算术右移，用异或符号位把它变成逻辑右移；位数 >= 64 时逻辑右移得 0，结果即符号填充
+CALC_TARGET("avx2") inline __m256i avx2Sra(__m256i x, __m256i count)
+{
+    const __m256i sign = _mm256_cmpgt_epi64(_mm256_setzero_si256(), x);
+    return _mm256_xor_si256(_mm256_srlv_epi64(_mm256_xor_si256(x, sign), count), sign);
+}
+
+#define CALC_AVX2_BINARY(name, expr) \
+    CALC_TARGET("avx2") void avx2##name(qint64 *a, const qint64 *b, int n) \
+    { \
+        for (int i = 0; i < n; i += 4) { \
+            const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i)); \
+            const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i)); \
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(a + i), expr); \
+        } \
+    } \
+    CALC_TARGET("avx2") void avx2##name##Scalar(qint64 *a, qint64 b, int n) \
+    { \
+        const __m256i y = _mm256_set1_epi64x(b); \
+        for (int i = 0; i < n; i += 4) { \
+            const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i)); \
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(a + i), expr); \
+        } \
+    }
+
+CALC_AVX2_BINARY(Add, _mm256_add_epi64(x, y))
+CALC_AVX2_BINARY(Sub, _mm256_sub_epi64(x, y))
+CALC_AVX2_BINARY(And, _mm256_and_si256(x, y))
+CALC_AVX2_BINARY(Or,  _mm256_or_si256(x, y))
+CALC_AVX2_BINARY(Xor, _mm256_xor_si256(x, y))
+CALC_AVX2_BINARY(Shl, _mm256_sllv_epi64(x, y))   // 位数 >= 64（含负数）时得 0
+CALC_AVX2_BINARY(Shr, avx2Sra(x, y))
+
+#undef CALC_AVX2_BINARY
+
+CALC_TARGET("avx2") void avx2Neg(qint64 *a, int n)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    for (int i = 0; i < n; i += 4) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(a + i), _mm256_sub_epi64(zero, x));
+    }
+}
+
+CALC_TARGET("avx2") void avx2Not(qint64 *a, int n)
+{
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    for (int i = 0; i < n; i += 4) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(a + i), _mm256_xor_si256(x, ones));
+    }
+}
+
+Kernels makeAvx2Kernels()
+{
+    Kernels k = makeScalarKernels(); // 乘除取模沿用标量
+    k.name = "avx2";
+
+    k.binary[OpAdd] = avx2Add;  k.scalar[OpAdd] = avx2AddScalar;
+    k.binary[OpSub] = avx2Sub;  k.scalar[OpSub] = avx2SubScalar;
+    k.binary[OpAnd] = avx2And;  k.scalar[OpAnd] = avx2AndScalar;
+    k.binary[OpOr]  = avx2Or;   k.scalar[OpOr]  = avx2OrScalar;
+    k.binary[OpXor] = avx2Xor;  k.scalar[OpXor] = avx2XorScalar;
+    k.binary[OpShl] = avx2Shl;  k.scalar[OpShl] = avx2ShlScalar;
+    k.binary[OpShr] = avx2Shr;  k.scalar[OpShr] = avx2ShrScalar;
+
+    k.unary[OpNeg] = avx2Neg;
+    k.unary[OpNot] = avx2Not;
+    return k;
+}
+
+// -------------------------------
+// AVX-512 内核：每次 8 个元素
+// -------------------------------
+#define CALC_AVX512_BINARY(name, expr) \
+    CALC_TARGET("avx512f") void avx512##name(qint64 *a, const qint64 *b, int n) \
+    { \
+        for (int i = 0; i < n; i += 8) { \
+            const __m512i x = _mm512_loadu_si512(a + i); \
+            const __m512i y = _mm512_loadu_si512(b + i); \
+            _mm512_storeu_si512(a + i, expr); \
+        } \
+    } \
+    CALC_TARGET("avx512f") void avx512##name##Scalar(qint64 *a, qint64 b, int n) \
+    { \
+        const __m512i y = _mm512_set1_epi64(b); \
+        for (int i = 0; i < n; i += 8) { \
+            const __m512i x = _mm512_loadu_si512(a + i); \
+            _mm512_storeu_si512(a + i, expr); \
+        } \
+    }
+
+CALC_AVX512_BINARY(Add, _mm512_add_epi64(x, y))
+CALC_AVX512_BINARY(Sub, _mm512_sub_epi64(x, y))
+CALC_AVX512_BINARY(And, _mm512_and_si512(x, y))
+CALC_AVX512_BINARY(Or,  _mm512_or_si512(x, y))
+CALC_AVX512_BINARY(Xor, _mm512_xor_si512(x, y))
+CALC_AVX512_BINARY(Shl, _mm512_sllv_epi64(x, y))   // 位数 >= 64 时得 0
+CALC_AVX512_BINARY(Shr, _mm512_srav_epi64(x, y))   // 位数 >= 64 时符号填充
+
+#undef CALC_AVX512_BINARY
+
+CALC_TARGET("avx512f") void avx512Neg(qint64 *a, int n)
+{
+    const __m512i zero = _mm512_setzero_si512();
+    for (int i = 0; i < n; i += 8)
+        _mm512_storeu_si512(a + i, _mm512_sub_epi64(zero, _mm512_loadu_si512(a + i)));
+}
+
+CALC_TARGET("avx512f") void avx512Not(qint64 *a, int n)
+{
+    const __m512i ones = _mm512_set1_epi64(-1);
+    for (int i = 0; i < n; i += 8)
+        _mm512_storeu_si512(a + i, _mm512_xor_si512(_mm512_loadu_si512(a + i), ones));
+}
+
+Kernels makeAvx512Kernels()
+{
+    Kernels k = makeScalarKernels();
+    k.name = "avx512";
+
+    k.binary[OpAdd] = avx512Add;  k.scalar[OpAdd] = avx512AddScalar;
+    k.binary[OpSub] = avx512Sub;  k.scalar[OpSub] = avx512SubScalar;
+    k.binary[OpAnd] = avx512And;  k.scalar[OpAnd] = avx512AndScalar;
+    k.binary[OpOr]  = avx512Or;   k.scalar[OpOr]  = avx512OrScalar;
+    k.binary[OpXor] = avx512Xor;  k.scalar[OpXor] = avx512XorScalar;
+    k.binary[OpShl] = avx512Shl;  k.scalar[OpShl] = avx512ShlScalar;
+    k.binary[OpShr] = avx512Shr;  k.scalar[OpShr] = avx512ShrScalar;
+
+    k.unary[OpNeg] = avx512Neg;
+    k.unary[OpNot] = avx512Not;
+    return k;
+}
+#endif // CALC_X86
+
+Kernels selectKernels()
+{
+#ifdef CALC_X86
+    const CpuFeatures &cpu = cpuFeatures();
+    if (cpu.avx512f) return makeAvx512Kernels();
+    if (cpu.avx2) return makeAvx2Kernels();
+#endif
+    return makeScalarKernels();
+}
+
+const Kernels &kernels()
+{
+    static const Kernels selected = selectKernels();
+    return selected;
+}
+
+// 对一块输入执行整个程序，返回结果所在的栈槽（程序为空时返回 nullptr）
+const qint64 *runBlock(const Program &program, const Kernels &k,
+                       const qint64 *in, int n, qint64 *stack)
+{
+    const int padded = (n + 7) & ~7; // 内核按 8 个元素一组处理，多出的元素不会写回
+    auto slot = [stack](int i) { return stack + i * BlockSize; };
+
+    const quint8 *pc = program.code.constData();
+    const quint8 *const end = pc + program.code.size();
+    const qint64 *imm = program.imms.constData();
+    int sp = 0;
+
+    while (pc != end) {
+        const quint8 op = *pc++;
+        switch (op) {
+        case OpPush:
+            // 立即数紧跟双目运算（如 x >> 12、& FFF）时直接用标量操作数内核，省去一次填充
+            if (pc != end && isBinary(*pc)) {
+                k.scalar[*pc](slot(sp - 1), *imm++, padded);
+                ++pc;
+            } else {
+                std::fill(slot(sp), slot(sp) + padded, *imm++);
+                ++sp;
+            }
+            break;
+        case OpVar:
+            memcpy(slot(sp), in, size_t(n) * sizeof(qint64));
+            ++sp;
+            break;
+        case OpNeg:
+        case OpNot:
+            k.unary[op](slot(sp - 1), padded);
+            break;
+        default:
+            k.binary[op](slot(sp - 2), slot(sp - 1), padded);
+            --sp;
+            break;
+        }
+    }
+
+    return sp > 0 ? slot(sp - 1) : nullptr;
+}
+
+} // namespace
+
+void executeColumn(const Program &program, const qint64 *in, qint64 *out, qsizetype count)
+{
+    if (count <= 0) return;
+
+    // 不引用 x 的程序与输入无关，只需计算一次
+    if (!program.usesVariable) {
+        std::fill(out, out + count, execute(program));
+        return;
+    }
+
+    const Kernels &k = kernels();
+    QVarLengthArray<qint64, 4 * BlockSize> stack(program.maxDepth * BlockSize);
+    std::fill(stack.data(), stack.data() + stack.size(), 0);
+
+    for (qsizetype start = 0; start < count; start += BlockSize) {
+        const int n = int(qMin<qsizetype>(BlockSize, count - start));
+        const qint64 *result = runBlock(program, k, in + start, n, stack.data());
+        if (result) memcpy(out + start, result, size_t(n) * sizeof(qint64));
+        else std::fill(out + start, out + start + n, 0);
+    }
+}
+
+const char *columnKernelName()
+{
+    return kernels().name;
+}
+
+} // namespace calc
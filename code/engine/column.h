@@ -0,0 +1,22 @@
+#ifndef COLUMN_H
+#define COLUMN_H
+
+#include <QtGlobal>
+
+#include "bytecode.h"
+
+namespace calc {
+
+// -------------------------------
+// 列式执行：同一程序作用于整列输入，out[i] = program(x = in[i])
+// 加减、位运算、取反和移位使用运行时选择的 AVX-512/AVX2 内核，乘除取模逐元素计算
+// in 与 out 可以是同一块内存
+// -------------------------------
+void executeColumn(const Program &program, const qint64 *in, qint64 *out, qsizetype count);
+
+// 当前选用的内核："avx512"、"avx2" 或 "scalar"
+const char *columnKernelName();
+
+} // namespace calc
+
+#endif // COLUMN_H
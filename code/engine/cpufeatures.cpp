@@ -0,0 +1,87 @@
+#include "cpufeatures.h"
+
+#include <QByteArray>
+#include <QtGlobal>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#  define CALC_X86 1
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#  else
+#    include <cpuid.h>
+#  endif
+#endif
+
+namespace calc {
+
+namespace {
+
+#ifdef CALC_X86
+void cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4])
+{
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuidex(r, int(leaf), int(subleaf));
+    for (int i = 0; i < 4; ++i) regs[i] = unsigned(r[i]);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+quint64 readXcr0()
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return (quint64(hi) << 32) | lo;
+#endif
+}
+#endif
+
+CpuFeatures detect()
+{
+    CpuFeatures features;
+#ifdef CALC_X86
+    unsigned regs[4];
+    cpuid(0, 0, regs);
+    if (regs[0] < 7) return features;
+    // 厂商字符串按 EBX、EDX、ECX 的顺序排列
+    const bool amd = (regs[1] == 0x68747541 && regs[3] == 0x69746e65 && regs[2] == 0x444d4163)   // AuthenticAMD
+                  || (regs[1] == 0x6f677948 && regs[3] == 0x6e65476e && regs[2] == 0x656e6975);  // HygonGenuine
+
+    cpuid(1, 0, regs);
+    unsigned family = (regs[0] >> 8) & 0xf;
+    if (family == 0xf) family += (regs[0] >> 20) & 0xff;
+    const bool osxsave = regs[2] & (1u << 27);
+    const bool avx = regs[2] & (1u << 28);
+    const quint64 xcr0 = osxsave ? readXcr0() : 0;
+    const bool ymmState = (xcr0 & 0x06) == 0x06;   // XMM + YMM
+    const bool zmmState = (xcr0 & 0xe6) == 0xe6;   // 再加 opmask + ZMM
+
+    cpuid(7, 0, regs);
+    features.bmi2 = regs[1] & (1u << 8);
+    features.fastBmi2 = features.bmi2 && !(amd && family < 0x19);   // 0x19 = Zen3
+    features.avx2 = avx && ymmState && (regs[1] & (1u << 5));
+    features.avx512f = features.avx2 && zmmState && (regs[1] & (1u << 16));
+#endif
+
+    const QByteArray force = qgetenv("CALC_SIMD");
+    if (force == "scalar") {
+        features = CpuFeatures();
+    } else if (force == "avx2") {
+        features.avx512f = false;
+    }
+    return features;
+}
+
+} // namespace
+
+const CpuFeatures &cpuFeatures()
+{
+    static const CpuFeatures features = detect();
+    return features;
+}
+
+} // namespace calc
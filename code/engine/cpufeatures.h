@@ -0,0 +1,21 @@
+#ifndef CPUFEATURES_H
+#define CPUFEATURES_H
+
+namespace calc {
+
+// 运行时检测到的 CPU 指令集支持（已确认操作系统保存了对应寄存器状态）
+struct CpuFeatures
+{
+    bool avx2 = false;
+    bool avx512f = false;
+    bool bmi2 = false;
+    // pext/pdep 是否为单周期实现；AMD Zen3 之前为微码实现，每条数十个周期
+    bool fastBmi2 = false;
+};
+
+// 首次调用时检测并缓存；环境变量 CALC_SIMD=scalar|avx2 可强制降级，便于对比
+const CpuFeatures &cpuFeatures();
+
+} // namespace calc
+
+#endif // CPUFEATURES_H
@@ -0,0 +1,14 @@
+# 链接计算引擎静态库（engine/engine.pro），由 app、cli、bench 包含
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+ENGINE_OUT = $$shadowed($$PWD)
+win32 {
+    CONFIG(debug, debug|release): ENGINE_OUT = $$ENGINE_OUT/debug
+    else: ENGINE_OUT = $$ENGINE_OUT/release
+}
+
+LIBS += -L$$ENGINE_OUT -lcalcengine
+
+win32-msvc*: PRE_TARGETDEPS += $$ENGINE_OUT/calcengine.lib
+else: PRE_TARGETDEPS += $$ENGINE_OUT/libcalcengine.a
@@ -0,0 +1,49 @@
+# 计算引擎静态库：表达式编译/执行、校验、解析与格式化，只依赖 QtCore
+# 所有接口可重入、没有可变的全局状态；calcapi.h 提供 C 接口
+TEMPLATE = lib
+CONFIG += staticlib c++11
+QT = core
+
+TARGET = calcengine
+
+SOURCES += \
+    bitfield.cpp \
+    bytecode.cpp \
+    calcapi.cpp \
+    column.cpp \
+    cpufeatures.cpp \
+    evalcache.cpp \
+    liveexpr.cpp \
+    format.cpp \
+    radix.cpp \
+    splitlayout.cpp \
+    tokenizer.cpp \
+    validator.cpp \
+    widevalue.cpp \
+    wideint.cpp
+
+HEADERS += \
+    base.h \
+    bitfield.h \
+    bytecode.h \
+    calcapi.h \
+    column.h \
+    cpufeatures.h \
+    evalcache.h \
+    liveexpr.h \
+    format.h \
+    ops.h \
+    radix.h \
+    splitlayout.h \
+    tokenizer.h \
+    validator.h \
+    widevalue.h \
+    wideint.h
+
+# 安装静态库和 C 接口头文件，供外部工具链接
+unix:!android {
+    target.path = /opt/cal/lib
+    capi.files = calcapi.h
+    capi.path = /opt/cal/include
+    INSTALLS += target capi
+}
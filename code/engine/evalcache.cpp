@@ -0,0 +1,192 @@
+#include "evalcache.h"
+
+#include <QChar>
+
+namespace calc {
+
+namespace {
+
+// 规范化的逐字符规则：把保留下来的字符连同它在原表达式中的下标交给 emit
+// 空白在词法分析中只起分隔作用（数字之间的空白也被跳过），唯一的例外是 < < 或 > >：
+// 它们不构成移位运算符，此时保留一个空格
+template<typename Emit>
+void normalizeChars(QStringView expr, int base, Emit emit)
+{
+    int space = -1;   // 上一个保留字符之后的第一个空白
+    ushort prev = 0;
+    for (int i = 0; i < int(expr.size()); ++i) {
+        ushort c = expr[i].unicode();
+        if (expr[i].isSpace()) {
+            if (space < 0) space = i;
+            continue;
+        }
+        if (base == HEX && c >= 'a' && c <= 'f') c = ushort(c - 'a' + 'A');
+        else if (c == 'X') c = 'x';
+
+        if (space >= 0 && (c == '<' || c == '>') && c == prev) emit(space, QLatin1Char(' '));
+        space = -1;
+        emit(i, QChar(c));
+        prev = c;
+    }
+}
+
+// 规范化文本中的下标换回原表达式中的下标；指向末尾时即原表达式的长度
+int originalColumn(QStringView expr, int base, int column)
+{
+    if (column < 0) return column;
+    int count = 0;
+    int found = int(expr.size());
+    normalizeChars(expr, base, [&](int index, QChar) {
+        if (count++ == column) found = index;
+    });
+    return qMin(found, int(expr.size()));
+}
+
+} // namespace
+
+EvaluationCache::EvaluationCache(int capacity)
+    : entries(qMax(1, capacity))
+{
+    int size = 2;
+    while (size < 2 * entries.size()) size *= 2;
+    buckets.fill(-1, size);
+}
+
+QString EvaluationCache::normalize(QStringView expr, int base)
+{
+    QString text;
+    text.reserve(int(expr.size()));
+    normalizeChars(expr, base, [&text](int, QChar c) { text.append(c); });
+    return text;
+}
+
+Evaluation EvaluationCache::evaluate(QStringView expr, int base, int valueBits, const WideValue &x)
+{
+    scratch.resize(0);
+    normalizeChars(expr, base, [this](int, QChar c) { scratch.append(c); });
+    const size_t hash = qHash(QStringView(scratch), uint(base) << 16 | uint(valueBits));
+
+    int index = find(hash, base, valueBits);
+    if (index >= 0) {
+        ++hitCount;
+        if (index != head) {
+            unlink(index);
+            pushFront(index);
+        }
+    } else {
+        ++missCount;
+        index = recycle(hash);
+        Entry &entry = entries[index];
+        // 按内容复制到该项自己的缓冲区，不与 scratch 共享，两者之后都不会因分离而重新分配
+        entry.text.setUnicode(scratch.constData(), scratch.size());
+        entry.base = base;
+        entry.valueBits = valueBits;
+        const Validation validation = validate(QStringView(scratch), base);
+        entry.error = validation.error;
+        entry.column = validation.column;
+        if (validation.ok()) {
+            compile(QStringView(scratch), base, valueBits, entry.program);
+            entry.column = entry.program.errorColumn;
+            if (entry.program.ok()) {
+                entry.x = x;
+                entry.value = execute(entry.program, x, valueBits);
+            }
+        }
+    }
+
+    Entry &entry = entries[index];
+    Evaluation result;
+    result.error = entry.error;
+    result.syntaxError = entry.error == NoError && !entry.program.ok();
+    if (!result.ok()) {
+        // 空表达式的位置恒为 0（同 validate），其余按规范化文本换算
+        result.column = entry.error == EmptyExpression ? 0 : originalColumn(expr, base, entry.column);
+        return result;
+    }
+
+    // 结果只取决于表达式时直接返回；引用了 x 且 x 变化时重新执行缓存的程序
+    if (entry.program.usesVariable && entry.x != x) {
+        entry.x = x;
+        entry.value = execute(entry.program, x, valueBits);
+    }
+    result.value = entry.value;
+    return result;
+}
+
+void EvaluationCache::clear()
+{
+    buckets.fill(-1);
+    used = 0;
+    head = tail = -1;
+}
+
+int EvaluationCache::find(size_t hash, int base, int valueBits) const
+{
+    const int mask = buckets.size() - 1;
+    for (int i = int(hash & size_t(mask)); buckets[i] >= 0; i = (i + 1) & mask) {
+        const Entry &entry = entries[buckets[i]];
+        if (entry.hash == hash && entry.base == base && entry.valueBits == valueBits && entry.text == scratch)
+            return buckets[i];
+    }
+    return -1;
+}
+
+// 取一个空闲的项，没有时淘汰最久未用的一项；放到链表头部并以 hash 登记到散列表
+int EvaluationCache::recycle(size_t hash)
+{
+    const int mask = buckets.size() - 1;
+    int index;
+    if (used < entries.size()) {
+        index = used++;
+    } else {
+        index = tail;
+        unlink(index);
+        int bucket = int(entries[index].hash & size_t(mask));
+        while (buckets[bucket] != index) bucket = (bucket + 1) & mask;
+        removeBucket(bucket);
+    }
+
+    entries[index].hash = hash;
+    int bucket = int(hash & size_t(mask));
+    while (buckets[bucket] >= 0) bucket = (bucket + 1) & mask;
+    buckets[bucket] = index;
+    pushFront(index);
+    return index;
+}
+
+void EvaluationCache::unlink(int index)
+{
+    Entry &entry = entries[index];
+    if (entry.prev >= 0) entries[entry.prev].next = entry.next;
+    else head = entry.next;
+    if (entry.next >= 0) entries[entry.next].prev = entry.prev;
+    else tail = entry.prev;
+    entry.prev = entry.next = -1;
+}
+
+void EvaluationCache::pushFront(int index)
+{
+    Entry &entry = entries[index];
+    entry.prev = -1;
+    entry.next = head;
+    if (head >= 0) entries[head].prev = index;
+    else tail = index;
+    head = index;
+}
+
+// 删除散列表中的一格：把后面探测链上的项前移补位，查找不会在中途遇到空格
+void EvaluationCache::removeBucket(int bucket)
+{
+    const int mask = buckets.size() - 1;
+    for (int next = (bucket + 1) & mask; buckets[next] >= 0; next = (next + 1) & mask) {
+        const int home = int(entries[buckets[next]].hash & size_t(mask));
+        // home 在 (bucket, next] 之间（循环意义下）的项不能移到 bucket 之前
+        const bool stays = bucket <= next ? (bucket < home && home <= next) : (bucket < home || home <= next);
+        if (stays) continue;
+        buckets[bucket] = buckets[next];
+        bucket = next;
+    }
+    buckets[bucket] = -1;
+}
+
+} // namespace calc
@@ -0,0 +1,83 @@
+#ifndef EVALCACHE_H
+#define EVALCACHE_H
+
+#include <QString>
+#include <QStringView>
+#include <QVector>
+
+#include "bytecode.h"
+#include "validator.h"
+#include "widevalue.h"
+
+namespace calc {
+
+// 一次求值的结果：校验或语法错误，或者计算出的数值
+struct Evaluation
+{
+    ValidationError error = NoError; // 字符层面的错误（同 validate）
+    bool syntaxError = false;        // 字符合法但语法错误（如 "3-*4"）
+    int column = -1;                 // 出错字符在原表达式中的下标
+    WideValue value;                 // 按位宽符号扩展的结果
+
+    bool ok() const { return error == NoError && !syntaxError; }
+};
+
+// -------------------------------
+// 求值结果缓存（LRU）：按规范化后的 (表达式, 进制, 位宽) 记住校验结果、编译好的程序和计算结果
+// 规范化去掉空白（<< 或 >> 中间的空白除外，它使表达式非法），十六进制数字统一为大写、变量统一为 x，
+// 因此只在空格或大小写上不同的表达式共用一项；出错位置按原表达式换算
+// 引用变量 x 的表达式在 x 变化时直接执行缓存的程序，不重新校验和编译
+// 缓存项按容量预先分配、循环使用：未命中时淘汰最久未用的一项，复用它的键和程序数组，
+// 索引为开放寻址的散列表，因此缓冲区够用后命中与未命中都不分配内存
+// -------------------------------
+class EvaluationCache
+{
+public:
+    explicit EvaluationCache(int capacity = 64);
+
+    Evaluation evaluate(QStringView expr, int base, int valueBits, const WideValue &x = WideValue());
+    void clear();   // 清空所有项，保留各项的缓冲区
+
+    // 命中：跳过校验和编译；未命中：完整地校验、编译并执行一次
+    qint64 hits() const { return hitCount; }
+    qint64 misses() const { return missCount; }
+
+    // 缓存所用的规范形式
+    static QString normalize(QStringView expr, int base);
+
+private:
+    struct Entry
+    {
+        QString text;        // 键：规范化的表达式、进制和位宽
+        int base = 0;
+        int valueBits = 0;
+        size_t hash = 0;
+        int prev = -1;       // LRU 链表中的前后项，表头为最近使用的一项
+        int next = -1;
+
+        ValidationError error = NoError;
+        int column = -1;     // 规范化文本中的下标
+        Program program;     // 校验通过时的编译结果（可能含语法错误）
+        WideValue x;         // value 对应的 x，仅在引用了 x 时有意义
+        WideValue value;
+    };
+
+    int find(size_t hash, int base, int valueBits) const;
+    int recycle(size_t hash);
+    void unlink(int index);
+    void pushFront(int index);
+    void removeBucket(int bucket);
+
+    QVector<Entry> entries;
+    QVector<int> buckets;      // 散列表（线性探测，不超过半满），存放项的下标，-1 为空
+    int used = 0;            // 已启用的项数，满了之后开始淘汰
+    int head = -1;
+    int tail = -1;
+    QString scratch;         // 规范化文本的缓冲区，不再分配
+    qint64 hitCount = 0;
+    qint64 missCount = 0;
+};
+
+} // namespace calc
+
+#endif // EVALCACHE_H
@@ -0,0 +1,331 @@
+#include "format.h"
+#include "radix.h"
+
+namespace calc {
+
+// -------------------------------
+// 二进制格式化
+// -------------------------------
+QString formatBinWithSpaces(const QString &bin)
+{
+    if (bin.isEmpty()) return bin;
+
+    // 一次分配，从右到左每四位加一个空格
+    const int length = bin.length() + (bin.length() - 1) / 4;
+    QString result(length, QLatin1Char(' '));
+    const QChar *src = bin.constData() + bin.length();
+    QChar *dst = result.data() + length;
+    for (int i = 0; i < bin.length(); i++) {
+        if (i > 0 && i % 4 == 0) --dst;
+        *--dst = *--src;
+    }
+    return result;
+}
+
+namespace {
+
+// 按最大长度准备缓冲区，写完后截到实际长度（缩短不会重新分配）
+template<typename Write>
+void fill(QString &target, int maxLength, Write write)
+{
+    target.resize(maxLength);
+    target.resize(write(target.data()));
+}
+
+// 分割结果的二进制文本：段内每四位加空格，段间以 '|' 分隔
+// Value 为 quint64 或 WideInt，取段和格式化按类型选择 64 位或宽整数实现
+template<typename Value>
+int writeBinSplit(QChar *out, const Value &value, const SplitLayout &layout, int valueBits, int count)
+{
+    QChar *p = out;
+    for (int i = 0; i < count; ++i) {
+        const SplitField field = layout.field(i, valueBits);
+        if (i > 0) *p++ = QLatin1Char('|');
+        p += formatBinField(p, SplitLayout::extract(value, field), field.width, true);
+    }
+    return int(p - out);
+}
+
+// 各段数值按指定进制输出，段间以 '|' 分隔
+template<typename Value>
+int writeSplitParts(QChar *out, const Value &value, const SplitLayout &layout, int valueBits, int count, int base)
+{
+    QChar *p = out;
+    for (int i = 0; i < count; ++i) {
+        if (i > 0) *p++ = QLatin1Char('|');
+        p += formatUnsigned(p, SplitLayout::extract(value, layout.field(i, valueBits)), base);
+    }
+    return int(p - out);
+}
+
+int binSplitLength(const SplitLayout &layout, int valueBits, int count)
+{
+    int length = count - 1;
+    for (int i = 0; i < count; ++i) length += binFieldLength(layout.field(i, valueBits).width, true);
+    return length;
+}
+
+// 宽整数各段按十进制或十六进制输出的最长文本（含分隔符）；十进制位数按 log10(2) ≈ 1233 / 4096 估计
+int splitPartsLength(const SplitLayout &layout, int valueBits, int count, int base, int maxWidth)
+{
+    int length = count - 1;
+    for (int i = 0; i < count; ++i) {
+        const int width = qMin(layout.field(i, valueBits).width, maxWidth);
+        length += base == HEX ? (width + 3) / 4 : ((width * 1233) >> 12) + 1;
+    }
+    return length;
+}
+
+// parseSplitParts 的共用部分；parse(text, base) 解析一段，返回 ParsedNumber 或 ParsedWideNumber
+template<typename Value, typename Parse>
+bool parseParts(QStringView text, const SplitLayout &layout, int valueBits, Value &value, Parse parse)
+{
+    const int count = layout.fieldCount(valueBits);
+    int separators = 0;
+    for (QChar c : text) {
+        if (c == QLatin1Char('|')) ++separators;
+    }
+    if (layout.isEmpty() || separators + 1 != count) return false;
+
+    // 从高位到低位逐段解析并写回：每段的位宽、偏移和掩码都已在布局中算好
+    Value result = Value();
+    qsizetype start = 0;
+    for (int i = 0; i < count; ++i) {
+        qsizetype end = start;
+        while (end < text.size() && text[end] != QLatin1Char('|')) ++end;
+        const auto part = parse(text.mid(start, end - start));
+        start = end + 1;
+        if (part.ok()) result = SplitLayout::insert(result, layout.field(i, valueBits), part.value);
+    }
+    value = result;
+    return true;
+}
+
+} // namespace
+
+QString formatBinWithSplit(quint64 value, const SplitLayout &layout)
+{
+    QString result;
+    if (layout.isEmpty()) {
+        fill(result, MaxNumberChars, [&](QChar *out) { return formatUnsigned(out, value, BIN); });
+        return result;
+    }
+
+    const int valueBits = bitLength(value);
+    const int count = layout.fieldCount(valueBits);
+    fill(result, binSplitLength(layout, valueBits, count), [&](QChar *out) {
+        return writeBinSplit(out, value, layout, valueBits, count);
+    });
+    return result;
+}
+
+QStringList convertSplitParts(quint64 value, const SplitLayout &layout, int base)
+{
+    const int valueBits = bitLength(value);
+    const int count = layout.fieldCount(valueBits);
+
+    QStringList parts;
+    parts.reserve(count);
+    QChar buffer[MaxNumberChars];
+    for (int i = 0; i < count; ++i) {
+        const quint64 part = SplitLayout::extract(value, layout.field(i, valueBits));
+        parts << QString(buffer, formatUnsigned(buffer, part, base));
+    }
+    return parts;
+}
+
+bool parseSplitParts(QStringView text, const SplitLayout &layout, int valueBits, int base, quint64 &value)
+{
+    return parseParts(text, layout, valueBits, value, [base](QStringView part) { return parseUnsigned(part, base); });
+}
+
+void formatValues(qint64 value, DisplayStrings &out)
+{
+    const quint64 bits = quint64(value);
+    fill(out.dec, MaxNumberChars, [&](QChar *p) { return formatNumber(p, value, DEC); });
+    fill(out.hex, MaxNumberChars, [&](QChar *p) { return formatNumber(p, value, HEX); });
+    fill(out.oct, MaxNumberChars, [&](QChar *p) { return formatNumber(p, value, OCT); });
+    fill(out.bin, MaxNumberChars, [&](QChar *p) { return formatBinField(p, bits, bitLength(bits), true); });
+}
+
+QString formatSplitField(quint64 value, const SplitField &field, int base)
+{
+    const quint64 part = SplitLayout::extract(value, field);
+    QString text;
+    if (base == BIN) {
+        fill(text, binFieldLength(field.width, true), [&](QChar *p) {
+            return formatBinField(p, part, field.width, true);
+        });
+    } else {
+        fill(text, MaxNumberChars, [&](QChar *p) { return formatUnsigned(p, part, base); });
+    }
+    return text;
+}
+
+void formatDisplay(qint64 value, const SplitLayout &layout, DisplayStrings &out)
+{
+    const quint64 bits = quint64(value);
+    formatValues(value, out);
+
+    const int valueBits = bitLength(bits);
+
+    if (layout.isEmpty()) {
+        fill(out.binSplit, MaxNumberChars, [&](QChar *p) { return formatUnsigned(p, bits, BIN); });
+        out.decSplit = out.dec;
+        out.hexSplit = out.hex;
+        return;
+    }
+
+    const int count = layout.fieldCount(valueBits);
+    fill(out.binSplit, binSplitLength(layout, valueBits, count), [&](QChar *p) {
+        return writeBinSplit(p, bits, layout, valueBits, count);
+    });
+    if (count <= 1) {
+        out.decSplit = out.dec;
+        out.hexSplit = out.hex;
+        return;
+    }
+
+    // 十进制每段最多 20 位、十六进制最多 16 位，另加分隔符
+    fill(out.decSplit, count * 21, [&](QChar *p) {
+        return writeSplitParts(p, bits, layout, valueBits, count, DEC);
+    });
+    fill(out.hexSplit, count * 17, [&](QChar *p) {
+        return writeSplitParts(p, bits, layout, valueBits, count, HEX);
+    });
+}
+
+// -------------------------------
+// 宽整数
+// -------------------------------
+template<int Bits>
+QString formatBinWithSplit(const WideInt<Bits> &value, const SplitLayout &layout)
+{
+    if (Bits == 64) return formatBinWithSplit(value.limb[0], layout);
+
+    QString result;
+    if (layout.isEmpty()) {
+        fill(result, maxNumberChars(Bits), [&](QChar *out) { return formatUnsigned(out, value, BIN); });
+        return result;
+    }
+
+    const int valueBits = value.bitLength();
+    const int count = layout.fieldCount(valueBits);
+    fill(result, binSplitLength(layout, valueBits, count), [&](QChar *out) {
+        return writeBinSplit(out, value, layout, valueBits, count);
+    });
+    return result;
+}
+
+template<int Bits>
+QStringList convertSplitParts(const WideInt<Bits> &value, const SplitLayout &layout, int base)
+{
+    if (Bits == 64) return convertSplitParts(value.limb[0], layout, base);
+
+    const int valueBits = value.bitLength();
+    const int count = layout.fieldCount(valueBits);
+
+    QStringList parts;
+    parts.reserve(count);
+    QChar buffer[maxNumberChars(Bits)];
+    for (int i = 0; i < count; ++i) {
+        const WideInt<Bits> part = SplitLayout::extract(value, layout.field(i, valueBits));
+        parts << QString(buffer, formatUnsigned(buffer, part, base));
+    }
+    return parts;
+}
+
+template<int Bits>
+bool parseSplitParts(QStringView text, const SplitLayout &layout, int valueBits, int base, WideInt<Bits> &value)
+{
+    return parseParts(text, layout, valueBits, value, [base](QStringView part) {
+        return parseUnsigned<Bits>(part, base);
+    });
+}
+
+template<int Bits>
+void formatDisplay(const WideInt<Bits> &value, const SplitLayout &layout, DisplayStrings &out)
+{
+    if (Bits == 64) {
+        formatDisplay(qint64(value.limb[0]), layout, out);
+        return;
+    }
+
+    formatValues(value, out);
+
+    const int maxChars = maxNumberChars(Bits);
+    const int valueBits = value.bitLength();
+
+    if (layout.isEmpty()) {
+        fill(out.binSplit, maxChars, [&](QChar *p) { return formatUnsigned(p, value, BIN); });
+        out.decSplit = out.dec;
+        out.hexSplit = out.hex;
+        return;
+    }
+
+    const int count = layout.fieldCount(valueBits);
+    fill(out.binSplit, binSplitLength(layout, valueBits, count), [&](QChar *p) {
+        return writeBinSplit(p, value, layout, valueBits, count);
+    });
+    if (count <= 1) {
+        out.decSplit = out.dec;
+        out.hexSplit = out.hex;
+        return;
+    }
+
+    fill(out.decSplit, splitPartsLength(layout, valueBits, count, DEC, Bits), [&](QChar *p) {
+        return writeSplitParts(p, value, layout, valueBits, count, DEC);
+    });
+    fill(out.hexSplit, splitPartsLength(layout, valueBits, count, HEX, Bits), [&](QChar *p) {
+        return writeSplitParts(p, value, layout, valueBits, count, HEX);
+    });
+}
+
+template<int Bits>
+void formatValues(const WideInt<Bits> &value, DisplayStrings &out)
+{
+    if (Bits == 64) {
+        formatValues(qint64(value.limb[0]), out);
+        return;
+    }
+
+    const int maxChars = maxNumberChars(Bits);
+    fill(out.dec, maxChars, [&](QChar *p) { return formatNumber(p, value, DEC); });
+    fill(out.hex, maxChars, [&](QChar *p) { return formatNumber(p, value, HEX); });
+    fill(out.oct, maxChars, [&](QChar *p) { return formatNumber(p, value, OCT); });
+    fill(out.bin, maxChars, [&](QChar *p) { return formatBinField(p, value, value.bitLength(), true); });
+}
+
+template<int Bits>
+QString formatSplitField(const WideInt<Bits> &value, const SplitField &field, int base)
+{
+    if (Bits == 64) return formatSplitField(value.limb[0], field, base);
+
+    const WideInt<Bits> part = SplitLayout::extract(value, field);
+    QString text;
+    if (base == BIN) {
+        fill(text, binFieldLength(field.width, true), [&](QChar *p) {
+            return formatBinField(p, part, field.width, true);
+        });
+    } else {
+        fill(text, maxNumberChars(Bits), [&](QChar *p) { return formatUnsigned(p, part, base); });
+    }
+    return text;
+}
+
+#define CALC_INSTANTIATE_FORMAT(Bits) \
+    template QString formatBinWithSplit<Bits>(const WideInt<Bits> &, const SplitLayout &); \
+    template QStringList convertSplitParts<Bits>(const WideInt<Bits> &, const SplitLayout &, int); \
+    template bool parseSplitParts<Bits>(QStringView, const SplitLayout &, int, int, WideInt<Bits> &); \
+    template void formatDisplay<Bits>(const WideInt<Bits> &, const SplitLayout &, DisplayStrings &); \
+    template void formatValues<Bits>(const WideInt<Bits> &, DisplayStrings &); \
+    template QString formatSplitField<Bits>(const WideInt<Bits> &, const SplitField &, int);
+
+CALC_INSTANTIATE_FORMAT(64)
+CALC_INSTANTIATE_FORMAT(128)
+CALC_INSTANTIATE_FORMAT(256)
+CALC_INSTANTIATE_FORMAT(512)
+
+#undef CALC_INSTANTIATE_FORMAT
+
+} // namespace calc
@@ -0,0 +1,64 @@
+#ifndef FORMAT_H
+#define FORMAT_H
+
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+
+#include "base.h"
+#include "splitlayout.h"
+
+namespace calc {
+
+// 每四位数字后加空格（从低位开始）
+QString formatBinWithSpaces(const QString &bin);
+
+// 按分割布局切分数值的二进制表示（64 位补码），段内每四位加空格，段间以 '|' 分隔
+// 布局为空时返回不带空格的二进制串
+QString formatBinWithSplit(quint64 value, const SplitLayout &layout);
+
+// 按分割布局逐段转换为指定进制（十六进制大写），与结果框显示一致
+QStringList convertSplitParts(quint64 value, const SplitLayout &layout, int base);
+
+// convertSplitParts 的逆过程：把以 '|' 分隔、高位在前的各段文本按布局写回一个数值
+// valueBits 决定高位剩余段的宽度；段内跳过空格，解析失败的段记为 0，超出段宽的部分被截掉
+// 布局为空或段数与布局不符时返回 false
+bool parseSplitParts(QStringView text, const SplitLayout &layout, int valueBits, int base, quint64 &value);
+
+// 一个数值在界面上的全部显示文本
+struct DisplayStrings
+{
+    QString dec;       // 带符号十进制
+    QString hex;       // 十六进制（大写，64 位补码）
+    QString oct;
+    QString bin;       // 二进制，每四位一个空格
+    QString binSplit;  // 二进制分割结果，同 formatBinWithSplit
+    QString decSplit;  // 各段十进制，段间以 '|' 分隔；不足两段时同 dec
+    QString hexSplit;  // 各段十六进制；不足两段时同 hex
+};
+
+// 一次生成全部显示文本：每个字符串预先按最大长度分配，一遍写完
+// 复用 out 中未被共享的字符串缓冲区：结果只留在 out 中时，重复调用不再分配内存；
+// 交给别处（如 QLineEdit::setText）后字符串被隐式共享，下次写入该字符串时先分离，重新分配一次
+void formatDisplay(qint64 value, const SplitLayout &layout, DisplayStrings &out);
+
+// 只生成四个数值框的文本（dec、hex、oct、bin），分割结果不需要重新生成时使用
+void formatValues(qint64 value, DisplayStrings &out);
+
+// 分割结果中的一段：BIN 补零到段宽并每四位加空格（同 binSplit），其余进制同 convertSplitParts
+QString formatSplitField(quint64 value, const SplitField &field, int base);
+
+// -------------------------------
+// 宽整数版本，规则同上、按 Bits 位补码；Bits 为 64 时直接转到上面的 64 位实现
+// -------------------------------
+template<int Bits> QString formatBinWithSplit(const WideInt<Bits> &value, const SplitLayout &layout);
+template<int Bits> QStringList convertSplitParts(const WideInt<Bits> &value, const SplitLayout &layout, int base);
+template<int Bits> bool parseSplitParts(QStringView text, const SplitLayout &layout, int valueBits, int base,
+                                        WideInt<Bits> &value);
+template<int Bits> void formatDisplay(const WideInt<Bits> &value, const SplitLayout &layout, DisplayStrings &out);
+template<int Bits> void formatValues(const WideInt<Bits> &value, DisplayStrings &out);
+template<int Bits> QString formatSplitField(const WideInt<Bits> &value, const SplitField &field, int base);
+
+} // namespace calc
+
+#endif // FORMAT_H
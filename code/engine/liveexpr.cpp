@@ -0,0 +1,287 @@
+#include "liveexpr.h"
+#include "bytecode.h"
+#include "validator.h"
+
+namespace calc {
+
+// -------------------------------
+// 增量切分
+// -------------------------------
+void LiveExpression::setText(QStringView text, int newBase)
+{
+    if (newBase != base) {
+        base = newBase;
+        source = text.toString();
+        relexAll();
+        return;
+    }
+
+    // 与上一次的文本比较出改动的区间：旧文本 [start, oldSize - tail) 换成新文本 [start, newSize - tail)
+    const int oldSize = int(source.size());
+    const int newSize = int(text.size());
+    const int common = qMin(oldSize, newSize);
+    int start = 0;
+    while (start < common && source[start] == text[start]) ++start;
+    if (start == oldSize && start == newSize) {
+        relexed = 0;
+        return;
+    }
+    int tail = 0;
+    while (tail < common - start && source[oldSize - 1 - tail] == text[newSize - 1 - tail]) ++tail;
+    const int newEnd = newSize - tail;
+    const int delta = newSize - oldSize;
+
+    // 从起点在改动之前的最后一个单元开始重新切分：数字跨空白相连、< > 与下一个字符组成移位，
+    // 都会向后看到改动处；再往前的单元只看到这个单元的开头，不受影响
+    int before = 0;  // 起点在改动之前的单元数
+    int high = int(tokens.size());
+    while (before < high) {
+        const int middle = (before + high) / 2;
+        if (tokens[middle].token.pos < start) before = middle + 1;
+        else high = middle;
+    }
+    const int first = qMax(0, before - 1);
+
+    Tokenizer lexer(text, base);
+    lexer.setPosition(before > 0 ? tokens[first].token.pos : 0);
+
+    // 切到改动之后、与某个旧单元的起点（平移后）重合为止：词法分析没有状态，其后的单元与旧单元相同
+    fresh.resize(0);
+    int end = int(tokens.size());  // 旧单元 [first, end) 被替换
+    int old = first;
+    for (;;) {
+        const Token token = lexer.next();
+        if (token.kind == TokEnd) break;
+        if (token.pos >= newEnd) {
+            const int oldPos = token.pos - delta;
+            while (old < tokens.size() && tokens[old].token.pos < oldPos) ++old;
+            if (old < tokens.size() && tokens[old].token.pos == oldPos) {
+                end = old;
+                break;
+            }
+        }
+        LiveToken live;
+        live.token = token;
+        fresh.append(live);
+    }
+
+    // 延伸到改动处的括号组，值已失效
+    for (int i = 0; i < first; ++i) {
+        if (tokens[i].match >= first) tokens[i].match = -1;
+    }
+
+    const int shift = int(fresh.size()) - (end - first);
+    if (shift > 0) tokens.insert(end, shift, LiveToken());
+    else if (shift < 0) tokens.remove(end + shift, -shift);
+    for (int i = 0; i < fresh.size(); ++i) tokens[first + i] = fresh[i];
+    for (int i = first + int(fresh.size()); i < tokens.size(); ++i) {
+        LiveToken &live = tokens[i];
+        live.token.pos += delta;
+        if (live.match >= 0) live.match += shift;
+    }
+
+    source.setUnicode(text.data(), int(text.size()));
+    relexed = int(fresh.size());
+}
+
+void LiveExpression::relexAll()
+{
+    tokens.clear();
+    Tokenizer lexer(QStringView(source), base);
+    for (Token token = lexer.next(); token.kind != TokEnd; token = lexer.next()) {
+        LiveToken live;
+        live.token = token;
+        tokens.append(live);
+    }
+    relexed = int(tokens.size());
+}
+
+void LiveExpression::invalidateGroups(bool variableOnly)
+{
+    for (LiveToken &live : tokens) {
+        if (!variableOnly || live.usesVariable) live.match = -1;
+    }
+}
+
+// -------------------------------
+// 增量求值：与 compile 的解析器同样的优先级爬升，边解析边计算
+// 左括号记下的值在组内没有改动时直接复用，跳到对应的右括号之后
+// -------------------------------
+template<int Bits>
+class LiveParser
+{
+public:
+    typedef WideInt<Bits> Value;
+
+    explicit LiveParser(LiveExpression &expr)
+        : expr(expr), tokens(expr.tokens), x(widthCast<Bits>(expr.x)), index(0), deepest(0) {}
+
+    void parse(Evaluation &result)
+    {
+        Value value;
+        bool usesVariable = false;
+        if (parseExpression(0, 0, value, usesVariable) && index == tokens.size()) {
+            result.value = widthCast<MaxValueBits>(value);
+            return;
+        }
+        // 出错位置同 compile：当前单元的起点，已到末尾时为文本长度
+        result.syntaxError = true;
+        result.column = index < tokens.size() ? tokens[index].token.pos : int(expr.source.size());
+    }
+
+private:
+    TokenKind currentKind() const { return index < tokens.size() ? tokens[index].token.kind : TokEnd; }
+
+    void advance()
+    {
+        ++index;
+        ++expr.parsed;
+    }
+
+    bool parseExpression(int minPrecedence, int nesting, Value &value, bool &usesVariable)
+    {
+        if (!parsePrefix(nesting, value, usesVariable)) return false;
+        for (;;) {
+            const TokenKind kind = currentKind();
+            const int precedence = binaryPrecedence(kind);
+            if (precedence < minPrecedence) return true;
+            advance();
+            Value rhs;
+            if (!parseExpression(precedence + 1, nesting, rhs, usesVariable)) return false;
+            value = applyBinary(kind, value, rhs);
+        }
+    }
+
+    bool parsePrefix(int nesting, Value &value, bool &usesVariable)
+    {
+        if (nesting > MaxNesting) return false;
+        deepest = qMax(deepest, nesting);
+
+        switch (currentKind()) {
+        case TokNumber:
+            value = literal(tokens[index].token);
+            advance();
+            return true;
+        case TokVar:
+            value = x;
+            usesVariable = true;
+            advance();
+            return true;
+        case TokLParen:
+            return parseGroup(nesting, value, usesVariable);
+        case TokMinus:
+        case TokTilde:
+        case TokPlus: {
+            const TokenKind kind = currentKind();
+            advance();
+            if (!parsePrefix(nesting + 1, value, usesVariable)) return false;
+            if (kind == TokMinus) value = ops::neg(value);
+            else if (kind == TokTilde) value = ~value;
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+
+    bool parseGroup(int nesting, Value &value, bool &usesVariable)
+    {
+        const int open = index;
+        LiveExpression::LiveToken &group = tokens[open];
+        if (group.match >= 0 && nesting + group.depth <= MaxNesting) {
+            value = widthCast<Bits>(group.value);
+            usesVariable = usesVariable || group.usesVariable;
+            deepest = qMax(deepest, nesting + group.depth);
+            index = group.match + 1;
+            return true;
+        }
+
+        const int outerDeepest = deepest;
+        deepest = nesting;
+        advance();
+        bool inner = false;
+        if (!parseExpression(0, nesting + 1, value, inner)) return false;
+        if (currentKind() != TokRParen) return false;
+
+        LiveExpression::LiveToken &closed = tokens[open];
+        closed.match = index;
+        closed.depth = deepest - nesting;
+        closed.usesVariable = inner;
+        closed.value = widthCast<MaxValueBits>(value);
+        deepest = qMax(outerDeepest, deepest);
+        usesVariable = usesVariable || inner;
+        advance();
+        return true;
+    }
+
+    // 按位宽重新累加字面量，超出有符号范围时取 0，与 compile 一致
+    Value literal(const Token &token) const
+    {
+        if (Bits == 64) return Value::fromInt64(token.value);
+
+        Value value;
+        bool overflow = false;
+        for (QChar c : QStringView(expr.source).mid(token.pos, token.length)) {
+            if (c.isSpace()) continue;
+            const ushort u = c.unicode();
+            const int digit = u <= '9' ? u - '0' : (u | 0x20) - 'a' + 10;
+            if (limbs::mulAdd(value.limb, Value::Limbs, quint64(expr.base), quint64(digit))) overflow = true;
+        }
+        if (value.isNegative()) overflow = true;
+        return overflow ? Value() : value;
+    }
+
+    static Value applyBinary(TokenKind kind, Value a, const Value &b)
+    {
+        switch (kind) {
+        case TokPlus:    return ops::add(a, b);
+        case TokMinus:   return ops::sub(a, b);
+        case TokStar:    return ops::mul(a, b);
+        case TokSlash:   return ops::div(a, b);
+        case TokPercent: return ops::mod(a, b);
+        case TokAmp:     a &= b; return a;
+        case TokPipe:    a |= b; return a;
+        case TokCaret:   a ^= b; return a;
+        case TokShl:     return ops::shl(a, b);
+        default:         return ops::shr(a, b);
+        }
+    }
+
+    LiveExpression &expr;
+    QVector<LiveExpression::LiveToken> &tokens;
+    const Value x;
+    int index;
+    int deepest;  // 当前括号组内到达的最大嵌套层数
+};
+
+Evaluation LiveExpression::evaluate(int bits, const WideValue &value)
+{
+    // 位宽变化时所有括号组的值都失效，x 变化时只有引用了 x 的组失效
+    if (bits != valueBits) {
+        invalidateGroups(false);
+        valueBits = bits;
+        x = value;
+    } else if (value != x) {
+        invalidateGroups(true);
+        x = value;
+    }
+
+    Evaluation result;
+    parsed = 0;
+    const Validation validation = validate(QStringView(source), base);
+    if (!validation.ok()) {
+        result.error = validation.error;
+        result.column = validation.column;
+        return result;
+    }
+
+    switch (bits) {
+    case 128: LiveParser<128>(*this).parse(result); break;
+    case 256: LiveParser<256>(*this).parse(result); break;
+    case 512: LiveParser<512>(*this).parse(result); break;
+    default: LiveParser<64>(*this).parse(result); break;
+    }
+    return result;
+}
+
+} // namespace calc
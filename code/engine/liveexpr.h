@@ -0,0 +1,61 @@
+#ifndef LIVEEXPR_H
+#define LIVEEXPR_H
+
+#include <QString>
+#include <QStringView>
+#include <QVector>
+
+#include "evalcache.h"
+#include "tokenizer.h"
+#include "widevalue.h"
+
+namespace calc {
+
+// -------------------------------
+// 边输入边求值的表达式（实时预览）：保留上一次的词法单元和各括号组的值
+// setText 与上一次的文本比较出改动的区间，只重新切分受影响的词法单元，其后的单元平移后直接接上；
+// evaluate 重新解析时，范围不含改动的括号组直接取上次的值，只有包住改动的各层括号需要重新计算
+// 结果（含出错位置）与 validate + compile + execute 一致
+// -------------------------------
+class LiveExpression
+{
+public:
+    void setText(QStringView text, int base);
+    Evaluation evaluate(int valueBits, const WideValue &x = WideValue());
+
+    const QString &text() const { return source; }
+    int tokenCount() const { return int(tokens.size()); }
+
+    // 上一次 setText 重新切分的单元数、上一次 evaluate 实际解析的单元数（跳过的括号组不计）
+    int relexedTokens() const { return relexed; }
+    int parsedTokens() const { return parsed; }
+
+private:
+    template<int Bits> friend class LiveParser;
+
+    struct LiveToken
+    {
+        Token token;
+        // 以下只用于左括号：上次解析得到的右括号下标和整组的值
+        int match = -1;            // 右括号的单元下标，-1 表示没有可用的值
+        int depth = 0;             // 组内相对的最大嵌套层数，复用时检查总层数
+        bool usesVariable = false;
+        WideValue value;           // 按 valueBits 位符号扩展
+    };
+
+    void relexAll();
+    void invalidateGroups(bool variableOnly);
+
+    QString source;
+    int base = DEC;
+    QVector<LiveToken> tokens;  // 不含 TokEnd
+    QVector<LiveToken> fresh;   // setText 重新切分出的单元，各次复用
+    int valueBits = 0;          // 括号组的值对应的位宽和 x
+    WideValue x;
+    int relexed = 0;
+    int parsed = 0;
+};
+
+} // namespace calc
+
+#endif // LIVEEXPR_H
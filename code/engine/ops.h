@@ -0,0 +1,47 @@
+#ifndef OPS_H
+#define OPS_H
+
+#include <QtGlobal>
+
+namespace calc {
+
+// -------------------------------
+// 64 位运算的统一语义（标量执行与列式 SIMD 内核保持一致）
+// -------------------------------
+namespace ops {
+
+inline qint64 add(qint64 a, qint64 b) { return qint64(quint64(a) + quint64(b)); }
+inline qint64 sub(qint64 a, qint64 b) { return qint64(quint64(a) - quint64(b)); }
+inline qint64 mul(qint64 a, qint64 b) { return qint64(quint64(a) * quint64(b)); }
+inline qint64 neg(qint64 a) { return qint64(0 - quint64(a)); }
+
+// 除数为 0 时结果为 0；INT64_MIN / -1 按补码回绕
+inline qint64 div(qint64 a, qint64 b)
+{
+    if (b == 0) return 0;
+    if (b == -1) return neg(a);
+    return a / b;
+}
+
+inline qint64 mod(qint64 a, qint64 b)
+{
+    if (b == 0 || b == -1) return 0;
+    return a % b;
+}
+
+// 移位位数超出 [0, 63]（含负数）时按逻辑结果饱和：左移得 0，右移得符号位填充
+inline qint64 shl(qint64 a, qint64 b)
+{
+    return quint64(b) < 64 ? qint64(quint64(a) << b) : 0;
+}
+
+inline qint64 shr(qint64 a, qint64 b)
+{
+    return quint64(b) < 64 ? (a >> b) : (a < 0 ? -1 : 0);
+}
+
+} // namespace ops
+
+} // namespace calc
+
+#endif // OPS_H
@@ -0,0 +1,600 @@
+#include "radix.h"
+#include "base.h"
+
+#include <cstring>
+
+namespace calc {
+
+namespace {
+
+// -------------------------------
+// 数字查找表，分别以 char 和 UTF-16 码元存放，按块 memcpy 到输出
+// -------------------------------
+template<typename Unit>
+struct DigitTables
+{
+    Unit bin[16][4];   // 半字节 -> 4 位二进制
+    Unit oct[64][2];   // 6 位 -> 2 位八进制
+    Unit hex[256][2];  // 字节 -> 2 位十六进制（大写）
+    Unit dec[100][2];  // 0..99 -> 2 位十进制
+
+    DigitTables()
+    {
+        const char *digits = "0123456789ABCDEF";
+        for (int i = 0; i < 16; ++i)
+            for (int b = 0; b < 4; ++b) bin[i][b] = Unit((i >> (3 - b)) & 1 ? '1' : '0');
+        for (int i = 0; i < 64; ++i) {
+            oct[i][0] = Unit(digits[i >> 3]);
+            oct[i][1] = Unit(digits[i & 7]);
+        }
+        for (int i = 0; i < 256; ++i) {
+            hex[i][0] = Unit(digits[i >> 4]);
+            hex[i][1] = Unit(digits[i & 15]);
+        }
+        for (int i = 0; i < 100; ++i) {
+            dec[i][0] = Unit(digits[i / 10]);
+            dec[i][1] = Unit(digits[i % 10]);
+        }
+    }
+};
+
+const DigitTables<char> charTables;
+const DigitTables<ushort> utf16Tables;
+
+inline const DigitTables<char> &tables(char *) { return charTables; }
+inline const DigitTables<ushort> &tables(ushort *) { return utf16Tables; }
+
+inline ushort *units(QChar *out) { return reinterpret_cast<ushort *>(out); }
+inline char *units(char *out) { return out; }
+
+inline int decimalDigits(quint64 value)
+{
+    int digits = 1;
+    for (quint64 limit = 10; value >= limit; limit *= 10) {
+        ++digits;
+        if (digits == 20) break;  // 10^19 之后再乘 10 会溢出，且 64 位最多 20 位
+    }
+    return digits;
+}
+
+// 先算出长度，再从末尾往前按块写入，返回写入的字符数
+template<typename Unit>
+int writeUnsigned(Unit *out, quint64 value, int base)
+{
+    const DigitTables<Unit> &t = tables(out);
+    int length;
+
+    switch (base) {
+    case BIN: {
+        length = bitLength(value);
+        Unit *p = out + length;
+        int remaining = length;
+        for (; remaining >= 4; remaining -= 4, value >>= 4) {
+            p -= 4;
+            memcpy(p, t.bin[value & 15], 4 * sizeof(Unit));
+        }
+        if (remaining > 0) memcpy(out, t.bin[value & 15] + 4 - remaining, size_t(remaining) * sizeof(Unit));
+        break;
+    }
+    case OCT: {
+        length = (bitLength(value) + 2) / 3;
+        Unit *p = out + length;
+        int remaining = length;
+        for (; remaining >= 2; remaining -= 2, value >>= 6) {
+            p -= 2;
+            memcpy(p, t.oct[value & 63], 2 * sizeof(Unit));
+        }
+        if (remaining > 0) *out = t.oct[value & 7][1];
+        break;
+    }
+    case HEX: {
+        length = (bitLength(value) + 3) / 4;
+        Unit *p = out + length;
+        int remaining = length;
+        for (; remaining >= 2; remaining -= 2, value >>= 8) {
+            p -= 2;
+            memcpy(p, t.hex[value & 255], 2 * sizeof(Unit));
+        }
+        if (remaining > 0) *out = t.hex[value & 15][1];
+        break;
+    }
+    default: {
+        length = decimalDigits(value);
+        Unit *p = out + length;
+        while (value >= 100) {
+            p -= 2;
+            memcpy(p, t.dec[value % 100], 2 * sizeof(Unit));
+            value /= 100;
+        }
+        if (value >= 10) memcpy(out, t.dec[value], 2 * sizeof(Unit));
+        else *out = t.dec[value][1];
+        break;
+    }
+    }
+    return length;
+}
+
+template<typename Unit>
+int writeNumber(Unit *out, qint64 value, int base)
+{
+    if (base == DEC && value < 0) {
+        *out = Unit('-');
+        return 1 + writeUnsigned(out + 1, 0 - quint64(value), DEC);
+    }
+    return writeUnsigned(out, quint64(value), base);
+}
+
+template<typename Unit>
+int writeBinField(Unit *out, quint64 value, int width, bool group)
+{
+    const DigitTables<Unit> &t = tables(out);
+    const int length = binFieldLength(width, group);
+    Unit *p = out + length;
+    for (int bit = 0; bit < width; bit += 4) {
+        const int chunk = qMin(4, width - bit);
+        const quint64 nibble = bit < 64 ? (value >> bit) & 15 : 0;
+        if (group && bit > 0) *--p = Unit(' ');
+        p -= chunk;
+        memcpy(p, t.bin[nibble] + 4 - chunk, size_t(chunk) * sizeof(Unit));
+    }
+    return length;
+}
+
+// -------------------------------
+// 解析
+// -------------------------------
+
+// ASCII 字符 -> 数字值（大小写十六进制均可），非数字为 0xFF
+struct DigitValues
+{
+    quint8 value[128];
+
+    DigitValues()
+    {
+        memset(value, 0xFF, sizeof(value));
+        for (int c = '0'; c <= '9'; ++c) value[c] = quint8(c - '0');
+        for (int c = 'A'; c <= 'F'; ++c) value[c] = quint8(c - 'A' + 10);
+        for (int c = 'a'; c <= 'f'; ++c) value[c] = quint8(c - 'a' + 10);
+    }
+};
+
+const DigitValues digitValues;
+
+inline uint unitValue(char c) { return uchar(c); }
+inline uint unitValue(ushort c) { return c; }
+
+// 一个 64 位字按字符宽度划分的车道：8 个字节或 4 个 UTF-16 码元
+template<typename Unit> struct Lanes;
+template<> struct Lanes<char> { enum { Count = 8, Bits = 8 }; };
+template<> struct Lanes<ushort> { enum { Count = 4, Bits = 16 }; };
+
+// 每个车道都填入 c
+template<typename Unit>
+inline quint64 broadcast(quint64 c)
+{
+    return (~quint64(0) / ((quint64(1) << Lanes<Unit>::Bits) - 1)) * c;
+}
+
+// 各车道是否落在 [lo, hi]，要求车道值 < 0x80；结果只保留各车道的最高位
+template<typename Unit>
+inline quint64 inRange(quint64 w, quint64 lo, quint64 hi)
+{
+    const quint64 top = quint64(1) << (Lanes<Unit>::Bits - 1);
+    const quint64 ge = w + broadcast<Unit>(top - lo);
+    const quint64 gt = w + broadcast<Unit>(top - 1 - hi);
+    return ge & ~gt & broadcast<Unit>(top);
+}
+
+// 校验一个字中的所有字符都是该进制的数字，并换成各车道的数字值
+template<typename Unit>
+inline bool swarDigits(quint64 w, int base, quint64 &digits)
+{
+    const quint64 top = broadcast<Unit>(quint64(1) << (Lanes<Unit>::Bits - 1));
+    const quint64 laneMax = (quint64(1) << Lanes<Unit>::Bits) - 1;
+    if (w & broadcast<Unit>(laneMax & ~quint64(0x7F))) return false;  // 含非 ASCII 字符
+
+    switch (base) {
+    case BIN:
+        if (inRange<Unit>(w, '0', '1') != top) return false;
+        digits = w & broadcast<Unit>(1);
+        return true;
+    case OCT:
+        if (inRange<Unit>(w, '0', '7') != top) return false;
+        digits = w & broadcast<Unit>(7);
+        return true;
+    case HEX: {
+        const quint64 digit = inRange<Unit>(w, '0', '9');
+        const quint64 alpha = inRange<Unit>(w | broadcast<Unit>(0x20), 'a', 'f');
+        if ((digit | alpha) != top) return false;
+        // 'A'/'a' 的低 4 位是 1，加 9 得到 10
+        digits = (w & broadcast<Unit>(0xF)) + (alpha >> (Lanes<Unit>::Bits - 1)) * 9;
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+// 把各车道的数字合并成一个数：首字符在最低车道，是最高位的数字
+template<typename Unit>
+inline quint64 gather(quint64 v, int digitBits)
+{
+    int width = Lanes<Unit>::Bits;
+    for (int count = Lanes<Unit>::Count; count > 1; count /= 2) {
+        quint64 even = 0;
+        for (int lane = 0; lane < count; lane += 2) even |= ((quint64(1) << digitBits) - 1) << (lane * width);
+        v = ((v & even) << digitBits) | ((v >> width) & even);
+        width *= 2;
+        digitBits *= 2;
+    }
+    return v;
+}
+
+template<typename Unit>
+ParsedNumber parseDigits(const Unit *text, int size, int base, bool allowSign)
+{
+    ParsedNumber result;
+    int i = 0;
+    bool negative = false;
+    if (allowSign && size > 0 && unitValue(text[0]) == '-') {
+        negative = true;
+        i = 1;
+    }
+
+    const int digitBits = base == BIN ? 1 : base == OCT ? 3 : base == HEX ? 4 : 0;
+    quint64 value = 0;
+    bool overflow = false;
+
+    while (i < size) {
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        // 整字全是数字时一次处理一个字，遇到分组字符或非法字符时退回逐字符
+        if (digitBits && size - i >= int(Lanes<Unit>::Count)) {
+            quint64 w;
+            quint64 digits;
+            memcpy(&w, text + i, sizeof(w));
+            if (swarDigits<Unit>(w, base, digits)) {
+                const int bits = digitBits * Lanes<Unit>::Count;
+                if (value >> (64 - bits)) overflow = true;
+                value = (value << bits) | gather<Unit>(digits, digitBits);
+                result.empty = false;
+                i += Lanes<Unit>::Count;
+                continue;
+            }
+        }
+#endif
+        const uint c = unitValue(text[i]);
+        const int digit = c < 128 ? digitValues.value[c] : 0xFF;
+        if (digit < base) {
+            if (digitBits) {
+                if (value >> (64 - digitBits)) overflow = true;
+                value = (value << digitBits) | quint64(digit);
+            } else {
+                if (value > (~quint64(0) - quint64(digit)) / 10) overflow = true;
+                value = value * 10 + quint64(digit);
+            }
+            result.empty = false;
+        } else if (c != ' ' && c != '|') {
+            result.errorPos = i;
+            break;
+        }
+        ++i;
+    }
+
+    // 带符号十进制按 qint64 范围检查
+    const quint64 signBit = quint64(1) << 63;
+    if (allowSign && (negative ? value > signBit : value >= signBit)) overflow = true;
+
+    result.value = negative ? 0 - value : value;
+    result.overflow = overflow;
+    return result;
+}
+
+// -------------------------------
+// 宽整数
+// -------------------------------
+
+template<int Bits>
+inline bool fitsUInt64(const WideInt<Bits> &value)
+{
+    for (int i = 1; i < WideInt<Bits>::Limbs; ++i) {
+        if (value.limb[i]) return false;
+    }
+    return true;
+}
+
+// 从第 pos 位起的 count 位（count <= 8），超出 Bits 的位为 0
+template<int Bits>
+inline uint bitsAt(const WideInt<Bits> &value, int pos, int count)
+{
+    if (pos >= Bits) return 0;
+    const int index = pos / 64;
+    const int offset = pos % 64;
+    quint64 bits = value.limb[index] >> offset;
+    if (offset + count > 64 && index + 1 < WideInt<Bits>::Limbs) bits |= value.limb[index + 1] << (64 - offset);
+    return uint(bits) & ((1u << count) - 1);
+}
+
+template<typename Unit, int Bits>
+int writeWideBinField(Unit *out, const WideInt<Bits> &value, int width, bool group)
+{
+    const DigitTables<Unit> &t = tables(out);
+    const int length = binFieldLength(width, group);
+    Unit *p = out + length;
+    for (int bit = 0; bit < width; bit += 4) {
+        const int chunk = qMin(4, width - bit);
+        if (group && bit > 0) *--p = Unit(' ');
+        p -= chunk;
+        memcpy(p, t.bin[bitsAt(value, bit, 4)] + 4 - chunk, size_t(chunk) * sizeof(Unit));
+    }
+    return length;
+}
+
+// 八进制、十六进制：每位数字对应固定的位数，从低位起逐位写入
+template<typename Unit, int Bits>
+int writeWidePow2(Unit *out, const WideInt<Bits> &value, int digitBits)
+{
+    const DigitTables<Unit> &t = tables(out);
+    const int length = (value.bitLength() + digitBits - 1) / digitBits;
+    for (int i = 0; i < length; ++i) out[length - 1 - i] = t.hex[bitsAt(value, i * digitBits, digitBits)][1];
+    return length;
+}
+
+// 小于 2^Bits 的 10^19、10^38、10^76、10^152，分治转换按级拆分
+template<int Bits>
+struct DecimalPowers
+{
+    WideInt<Bits> power[4];
+    int digits[4];
+    int levels;
+
+    DecimalPowers() : levels(0)
+    {
+        WideInt<Bits> p = WideInt<Bits>::fromUInt64(Q_UINT64_C(10000000000000000000));
+        // 10^d < 2^Bits 即 d * log2(10) < Bits
+        for (int d = 19; levels < 4 && d * 3322 < Bits * 1000; d *= 2) {
+            power[levels] = p;
+            digits[levels] = d;
+            ++levels;
+            p = ops::mul(p, p);
+        }
+    }
+};
+
+template<int Bits>
+const DecimalPowers<Bits> &decimalPowers()
+{
+    static const DecimalPowers<Bits> powers;
+    return powers;
+}
+
+// 补零到 width 位的十进制，width 为 0 时不补零
+template<typename Unit>
+int writeDecimalPadded(Unit *out, quint64 value, int width)
+{
+    const int zeros = qMax(0, width - decimalDigits(value));
+    for (int i = 0; i < zeros; ++i) out[i] = Unit('0');
+    return zeros + writeUnsigned(out + zeros, value, DEC);
+}
+
+// 分治转换：value < 10^(2 * digits[level])，除以 10^digits[level] 得到高低两半分别递归，
+// 低半补零到 digits[level] 位；落到 64 位以内后查表输出
+template<typename Unit, int Bits>
+int writeDecimal(Unit *out, const WideInt<Bits> &value, int level, int width)
+{
+    if (level < 0 || fitsUInt64(value)) return writeDecimalPadded(out, value.limb[0], width);
+
+    const DecimalPowers<Bits> &powers = decimalPowers<Bits>();
+    WideInt<Bits> high, low;
+    limbs::divmod(value.limb, powers.power[level].limb, WideInt<Bits>::Limbs, high.limb, low.limb);
+    if (high.isZero()) return writeDecimal(out, low, level - 1, width);
+
+    const int lowDigits = powers.digits[level];
+    const int length = writeDecimal(out, high, level - 1, qMax(0, width - lowDigits));
+    return length + writeDecimal(out + length, low, level - 1, lowDigits);
+}
+
+template<typename Unit, int Bits>
+int writeWideUnsigned(Unit *out, const WideInt<Bits> &value, int base)
+{
+    switch (base) {
+    case BIN: return writeWideBinField(out, value, value.bitLength(), false);
+    case OCT: return writeWidePow2(out, value, 3);
+    case HEX: return writeWidePow2(out, value, 4);
+    default:  return writeDecimal(out, value, decimalPowers<Bits>().levels - 1, 0);
+    }
+}
+
+template<typename Unit, int Bits>
+int writeWideNumber(Unit *out, const WideInt<Bits> &value, int base)
+{
+    if (base == DEC && value.isNegative()) {
+        *out = Unit('-');
+        return 1 + writeWideUnsigned(out + 1, ops::neg(value), DEC);
+    }
+    return writeWideUnsigned(out, value, base);
+}
+
+template<int Bits, typename Unit>
+ParsedWideNumber<Bits> parseWideDigits(const Unit *text, int size, int base, bool allowSign)
+{
+    ParsedWideNumber<Bits> result;
+    if (Bits == 64) {
+        const ParsedNumber narrow = parseDigits(text, size, base, allowSign);
+        result.value = WideInt<Bits>::fromUInt64(narrow.value);
+        result.overflow = narrow.overflow;
+        result.errorPos = narrow.errorPos;
+        result.empty = narrow.empty;
+        return result;
+    }
+
+    int i = 0;
+    bool negative = false;
+    if (allowSign && size > 0 && unitValue(text[0]) == '-') {
+        negative = true;
+        i = 1;
+    }
+
+    // chunk 为攒下的数字，scale 为 base 的相应次幂；再乘一次 base 会超出 64 位时并入结果
+    WideInt<Bits> &value = result.value;
+    const quint64 scaleLimit = ~quint64(0) / quint64(base);
+    quint64 chunk = 0;
+    quint64 scale = 1;
+    auto flush = [&]() {
+        if (scale == 1) return;
+        if (limbs::mulAdd(value.limb, WideInt<Bits>::Limbs, scale, chunk)) result.overflow = true;
+        chunk = 0;
+        scale = 1;
+    };
+
+    for (; i < size; ++i) {
+        const uint c = unitValue(text[i]);
+        const int digit = c < 128 ? digitValues.value[c] : 0xFF;
+        if (digit < base) {
+            chunk = chunk * quint64(base) + quint64(digit);
+            scale *= quint64(base);
+            result.empty = false;
+            if (scale > scaleLimit) flush();
+        } else if (c != ' ' && c != '|') {
+            result.errorPos = i;
+            break;
+        }
+    }
+    flush();
+
+    // 带符号十进制按 Bits 位有符号范围检查：只有负数可以取到 -2^(Bits-1)
+    if (allowSign && value.isNegative()) {
+        WideInt<Bits> minimum;
+        minimum.limb[WideInt<Bits>::Limbs - 1] = quint64(1) << 63;
+        if (!negative || value != minimum) result.overflow = true;
+    }
+    if (negative) value = ops::neg(value);
+    return result;
+}
+
+} // namespace
+
+int formatUnsigned(QChar *out, quint64 value, int base) { return writeUnsigned(units(out), value, base); }
+int formatUnsigned(char *out, quint64 value, int base) { return writeUnsigned(units(out), value, base); }
+
+int formatNumber(QChar *out, qint64 value, int base) { return writeNumber(units(out), value, base); }
+int formatNumber(char *out, qint64 value, int base) { return writeNumber(units(out), value, base); }
+
+int formatBinField(QChar *out, quint64 value, int width, bool group)
+{
+    return writeBinField(units(out), value, width, group);
+}
+
+int formatBinField(char *out, quint64 value, int width, bool group)
+{
+    return writeBinField(units(out), value, width, group);
+}
+
+ParsedNumber parseUnsigned(QStringView text, int base)
+{
+    return parseDigits(reinterpret_cast<const ushort *>(text.data()), int(text.size()), base, false);
+}
+
+ParsedNumber parseUnsigned(const char *text, int size, int base)
+{
+    return parseDigits(text, size, base, false);
+}
+
+ParsedNumber parseNumber(QStringView text, int base)
+{
+    return parseDigits(reinterpret_cast<const ushort *>(text.data()), int(text.size()), base, base == DEC);
+}
+
+ParsedNumber parseNumber(const char *text, int size, int base)
+{
+    return parseDigits(text, size, base, base == DEC);
+}
+
+// -------------------------------
+// 宽整数接口，按支持的位宽显式实例化
+// -------------------------------
+template<int Bits>
+int formatUnsigned(QChar *out, const WideInt<Bits> &value, int base)
+{
+    if (Bits == 64) return formatUnsigned(out, value.limb[0], base);
+    return writeWideUnsigned(units(out), value, base);
+}
+
+template<int Bits>
+int formatUnsigned(char *out, const WideInt<Bits> &value, int base)
+{
+    if (Bits == 64) return formatUnsigned(out, value.limb[0], base);
+    return writeWideUnsigned(units(out), value, base);
+}
+
+template<int Bits>
+int formatNumber(QChar *out, const WideInt<Bits> &value, int base)
+{
+    if (Bits == 64) return formatNumber(out, qint64(value.limb[0]), base);
+    return writeWideNumber(units(out), value, base);
+}
+
+template<int Bits>
+int formatNumber(char *out, const WideInt<Bits> &value, int base)
+{
+    if (Bits == 64) return formatNumber(out, qint64(value.limb[0]), base);
+    return writeWideNumber(units(out), value, base);
+}
+
+template<int Bits>
+int formatBinField(QChar *out, const WideInt<Bits> &value, int width, bool group)
+{
+    if (Bits == 64) return formatBinField(out, value.limb[0], width, group);
+    return writeWideBinField(units(out), value, width, group);
+}
+
+template<int Bits>
+int formatBinField(char *out, const WideInt<Bits> &value, int width, bool group)
+{
+    if (Bits == 64) return formatBinField(out, value.limb[0], width, group);
+    return writeWideBinField(units(out), value, width, group);
+}
+
+template<int Bits>
+ParsedWideNumber<Bits> parseUnsigned(QStringView text, int base)
+{
+    return parseWideDigits<Bits>(reinterpret_cast<const ushort *>(text.data()), int(text.size()), base, false);
+}
+
+template<int Bits>
+ParsedWideNumber<Bits> parseUnsigned(const char *text, int size, int base)
+{
+    return parseWideDigits<Bits>(text, size, base, false);
+}
+
+template<int Bits>
+ParsedWideNumber<Bits> parseNumber(QStringView text, int base)
+{
+    return parseWideDigits<Bits>(reinterpret_cast<const ushort *>(text.data()), int(text.size()), base, base == DEC);
+}
+
+template<int Bits>
+ParsedWideNumber<Bits> parseNumber(const char *text, int size, int base)
+{
+    return parseWideDigits<Bits>(text, size, base, base == DEC);
+}
+
+#define CALC_INSTANTIATE_RADIX(Bits) \
+    template int formatUnsigned<Bits>(QChar *, const WideInt<Bits> &, int); \
+    template int formatUnsigned<Bits>(char *, const WideInt<Bits> &, int); \
+    template int formatNumber<Bits>(QChar *, const WideInt<Bits> &, int); \
+    template int formatNumber<Bits>(char *, const WideInt<Bits> &, int); \
+    template int formatBinField<Bits>(QChar *, const WideInt<Bits> &, int, bool); \
+    template int formatBinField<Bits>(char *, const WideInt<Bits> &, int, bool); \
+    template ParsedWideNumber<Bits> parseUnsigned<Bits>(QStringView, int); \
+    template ParsedWideNumber<Bits> parseUnsigned<Bits>(const char *, int, int); \
+    template ParsedWideNumber<Bits> parseNumber<Bits>(QStringView, int); \
+    template ParsedWideNumber<Bits> parseNumber<Bits>(const char *, int, int);
+
+CALC_INSTANTIATE_RADIX(64)
+CALC_INSTANTIATE_RADIX(128)
+CALC_INSTANTIATE_RADIX(256)
+CALC_INSTANTIATE_RADIX(512)
+
+#undef CALC_INSTANTIATE_RADIX
+
+} // namespace calc
@@ -0,0 +1,98 @@
+#ifndef RADIX_H
+#define RADIX_H
+
+#include <QChar>
+#include <QStringView>
+
+#include "wideint.h"
+
+namespace calc {
+
+// 单个 64 位数值最长的文本：64 位二进制加 15 个分组空格
+const int MaxNumberChars = 80;
+
+// Bits 位数值最长的文本，同样按二进制加分组空格计
+Q_DECL_CONSTEXPR inline int maxNumberChars(int bits) { return bits + bits / 4; }
+
+// -------------------------------
+// 查表进制格式化：直接写入调用方提供的缓冲区，返回写入的字符数，不分配内存
+// BIN 每次查一个半字节，OCT 每次两位数字（6 位），HEX 每次一个字节，DEC 每次两位十进制数字
+// 同时提供 QChar（界面）和 char（命令行输出）两种缓冲区
+// -------------------------------
+
+// 无符号、不补零的数字串，十六进制大写
+int formatUnsigned(QChar *out, quint64 value, int base);
+int formatUnsigned(char *out, quint64 value, int base);
+
+// 界面显示规则：十进制带符号，其余进制按 64 位补码
+int formatNumber(QChar *out, qint64 value, int base);
+int formatNumber(char *out, qint64 value, int base);
+
+// 补零到 width 位的二进制（width 可超过 64，高位为 0），group 为真时从低位起每四位插入空格
+int formatBinField(QChar *out, quint64 value, int width, bool group);
+int formatBinField(char *out, quint64 value, int width, bool group);
+
+// formatBinField 写入的字符数
+inline int binFieldLength(int width, bool group)
+{
+    return width + (group && width > 0 ? (width - 1) / 4 : 0);
+}
+
+// -------------------------------
+// 一遍扫描的进制解析：跳过分组字符 ' ' 和 '|'，边累加边检查溢出
+// BIN/OCT/HEX 在小端机器上每次按 64 位字（4 个 UTF-16 字符或 8 个字节）校验并合并数字（SWAR）
+// -------------------------------
+struct ParsedNumber
+{
+    quint64 value = 0;      // 解析结果（64 位补码，十进制负数已取负）
+    bool overflow = false;  // 超出 64 位（带符号十进制超出 qint64 范围）
+    int errorPos = -1;      // 第一个非法字符的下标，-1 表示没有
+    bool empty = true;      // 没有任何数字
+
+    bool ok() const { return !overflow && errorPos < 0 && !empty; }
+};
+
+// 64 位无符号数，不接受符号
+ParsedNumber parseUnsigned(QStringView text, int base);
+ParsedNumber parseUnsigned(const char *text, int size, int base);
+
+// 数值框的规则：十进制允许开头的负号并按 qint64 范围检查，其余进制按 64 位补码
+ParsedNumber parseNumber(QStringView text, int base);
+ParsedNumber parseNumber(const char *text, int size, int base);
+
+// -------------------------------
+// 宽整数的格式化与解析，规则同上、按 Bits 位补码；Bits 为 64 时直接转到上面的原生实现
+// 十进制输出按 10^19、10^38、10^76、10^152 分治：每级一次长除拆成高低两半，递归到 64 位后查表
+// 解析按块累加：攒满不超过 64 位的一块数字（如十进制 19 位）后整体乘加一次
+// -------------------------------
+template<int Bits> int formatUnsigned(QChar *out, const WideInt<Bits> &value, int base);
+template<int Bits> int formatUnsigned(char *out, const WideInt<Bits> &value, int base);
+
+template<int Bits> int formatNumber(QChar *out, const WideInt<Bits> &value, int base);
+template<int Bits> int formatNumber(char *out, const WideInt<Bits> &value, int base);
+
+// width 可超过 Bits，高位为 0
+template<int Bits> int formatBinField(QChar *out, const WideInt<Bits> &value, int width, bool group);
+template<int Bits> int formatBinField(char *out, const WideInt<Bits> &value, int width, bool group);
+
+template<int Bits>
+struct ParsedWideNumber
+{
+    WideInt<Bits> value;    // 解析结果（Bits 位补码，十进制负数已取负）
+    bool overflow = false;  // 超出 Bits 位（带符号十进制超出 Bits 位有符号范围）
+    int errorPos = -1;
+    bool empty = true;
+
+    bool ok() const { return !overflow && errorPos < 0 && !empty; }
+};
+
+// 用法如 parseUnsigned<256>(text, base)
+template<int Bits> ParsedWideNumber<Bits> parseUnsigned(QStringView text, int base);
+template<int Bits> ParsedWideNumber<Bits> parseUnsigned(const char *text, int size, int base);
+
+template<int Bits> ParsedWideNumber<Bits> parseNumber(QStringView text, int base);
+template<int Bits> ParsedWideNumber<Bits> parseNumber(const char *text, int size, int base);
+
+} // namespace calc
+
+#endif // RADIX_H
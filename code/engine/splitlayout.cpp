@@ -0,0 +1,96 @@
+#include "splitlayout.h"
+#include "bitfield.h"
+
+#include <QChar>
+
+namespace calc {
+
+namespace {
+
+// 单段位宽上限，超出视为无效段（避免生成超长的补零文本）
+const int MaxFieldBits = 0xFFFF;
+
+// 宽 width、从第 shift 位开始的一段在 64 位数值中的掩码
+inline quint64 bitsOf(int width, int shift)
+{
+    if (shift >= 64) return 0;
+    const quint64 mask = width >= 64 ? ~quint64(0) : (quint64(1) << width) - 1;
+    return mask << shift;
+}
+
+// 解析一段位宽（允许首尾空白和正号），无效时返回 0
+int parseWidth(QStringView piece)
+{
+    piece = piece.trimmed();
+    if (!piece.isEmpty() && piece[0] == QLatin1Char('+')) piece = piece.mid(1);
+    if (piece.isEmpty()) return 0;
+
+    int width = 0;
+    for (QChar c : piece) {
+        if (c < QLatin1Char('0') || c > QLatin1Char('9')) return 0;
+        width = width * 10 + (c.unicode() - '0');
+        if (width > MaxFieldBits) return 0;
+    }
+    return width;
+}
+
+} // namespace
+
+SplitLayout::SplitLayout(QStringView rule)
+{
+    // 逗号分隔，忽略无效或非正的段
+    qsizetype start = 0;
+    for (qsizetype i = 0; i <= rule.size(); ++i) {
+        if (i < rule.size() && rule[i] != QLatin1Char(',')) continue;
+        const int width = parseWidth(rule.mid(start, i - start));
+        if (width > 0) {
+            SplitField field;
+            field.width = width;
+            ruleFields.append(field);
+            ruleBits += width;
+        }
+        start = i + 1;
+    }
+
+    // 偏移从最低位的段开始累加
+    int shift = 0;
+    for (int i = ruleFields.size() - 1; i >= 0; --i) {
+        ruleFields[i].shift = shift;
+        ruleFields[i].bits = bitsOf(ruleFields[i].width, shift);
+        shift += ruleFields[i].width;
+    }
+}
+
+int SplitLayout::fieldCount(int valueBits) const
+{
+    if (ruleFields.isEmpty()) return 1;
+    return ruleFields.size() + (remainderBits(valueBits) > 0 ? 1 : 0);
+}
+
+SplitField SplitLayout::field(int index, int valueBits) const
+{
+    const int remainder = ruleFields.isEmpty() ? valueBits : remainderBits(valueBits);
+    if (remainder > 0) {
+        if (index == 0) {
+            SplitField high;
+            high.width = remainder;
+            high.shift = ruleBits;
+            high.bits = bitsOf(remainder, ruleBits);
+            return high;
+        }
+        --index;
+    }
+    return ruleFields[index];
+}
+
+quint64 SplitLayout::extract(quint64 value, const SplitField &field)
+{
+    return extractBits(value, field.bits);
+}
+
+quint64 SplitLayout::insert(quint64 value, const SplitField &field, quint64 part)
+{
+    return (value & ~field.bits) | depositBits(part, field.bits);
+}
+
+} // namespace calc
@@ -0,0 +1,78 @@
+#ifndef SPLITLAYOUT_H
+#define SPLITLAYOUT_H
+
+#include <QStringView>
+#include <QVector>
+
+#include "wideint.h"
+
+namespace calc {
+
+// 分割后的一段：位宽、相对最低位的偏移和该段在 64 位数值中占用的位
+struct SplitField
+{
+    int width = 0;
+    int shift = 0;
+    quint64 bits = 0;  // 超出 64 位的部分被截掉；提取 / 写入按此掩码进行（pext/pdep）
+};
+
+// -------------------------------
+// 解析一次的分割规则（如 "1,2,4"，从高位应用）
+// 规则只描述低 totalBits() 位；数值更长时，多出的高位作为最前面的"剩余段"
+// -------------------------------
+class SplitLayout
+{
+public:
+    SplitLayout() = default;
+    explicit SplitLayout(QStringView rule);
+
+    bool isEmpty() const { return ruleFields.isEmpty(); }
+    int totalBits() const { return ruleBits; }
+
+    // 二进制位数为 valueBits 的数值被切成的段数，以及从高位数起的第 index 段
+    int fieldCount(int valueBits) const;
+    SplitField field(int index, int valueBits) const;
+
+    // 取出 / 写入一段的值，偏移超出 64 位的段恒为 0；写入时超出位宽的部分被截掉
+    static quint64 extract(quint64 value, const SplitField &field);
+    static quint64 insert(quint64 value, const SplitField &field, quint64 part);
+
+    // 宽整数版本：按段的偏移移位、按位宽截取，偏移超出 Bits 位的段恒为 0；Bits 为 64 时同上
+    template<int Bits> static WideInt<Bits> extract(const WideInt<Bits> &value, const SplitField &field);
+    template<int Bits> static WideInt<Bits> insert(const WideInt<Bits> &value, const SplitField &field,
+                                                   const WideInt<Bits> &part);
+
+private:
+    int remainderBits(int valueBits) const { return qMax(0, valueBits - ruleBits); }
+
+    QVector<SplitField> ruleFields;  // 规则定义的段，从高位到低位
+    int ruleBits = 0;
+};
+
+template<int Bits>
+WideInt<Bits> SplitLayout::extract(const WideInt<Bits> &value, const SplitField &field)
+{
+    if (Bits == 64) return WideInt<Bits>::fromUInt64(extract(value.limb[0], field));
+    if (field.shift >= Bits) return WideInt<Bits>();
+    WideInt<Bits> part = shiftRight(value, field.shift, false);
+    part &= lowBitsMask<Bits>(field.width);
+    return part;
+}
+
+template<int Bits>
+WideInt<Bits> SplitLayout::insert(const WideInt<Bits> &value, const SplitField &field, const WideInt<Bits> &part)
+{
+    if (Bits == 64) return WideInt<Bits>::fromUInt64(insert(value.limb[0], field, part.limb[0]));
+    if (field.shift >= Bits) return value;
+    const WideInt<Bits> mask = lowBitsMask<Bits>(field.width);
+    WideInt<Bits> bits = part;
+    bits &= mask;
+    WideInt<Bits> result = value;
+    result &= ~shiftLeft(mask, field.shift);
+    result |= shiftLeft(bits, field.shift);
+    return result;
+}
+
+} // namespace calc
+
+#endif // SPLITLAYOUT_H
@@ -0,0 +1,112 @@
+#include "tokenizer.h"
+
+#include <QChar>
+
+namespace calc {
+
+Tokenizer::Tokenizer(QStringView text, int base)
+    : text(text), length(int(text.size())), pos(0), base(base)
+{
+}
+
+// 当前进制下的数字值，不是数字时返回 -1
+int Tokenizer::digitValue(ushort c) const
+{
+    int digit;
+    if (c >= '0' && c <= '9') digit = c - '0';
+    else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+    else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+    else return -1;
+    return digit < base ? digit : -1;
+}
+
+void Tokenizer::setPosition(int position)
+{
+    pos = position;
+}
+
+void Tokenizer::skipSpaces()
+{
+    while (pos < length && text[pos].isSpace()) ++pos;
+}
+
+Token Tokenizer::next()
+{
+    skipSpaces();
+
+    Token token;
+    token.pos = pos;
+    if (pos >= length) return token;
+
+    const ushort c = text[pos].unicode();
+    const int digit = digitValue(c);
+    if (digit >= 0) {
+        // 按无符号累加，超出 qint64 范围时取 0（与 QString::toLongLong 失败时一致）
+        const quint64 limit = quint64(Q_INT64_C(0x7fffffffffffffff));
+        quint64 value = 0;
+        bool overflow = false;
+        for (;;) {
+            int d = -1;
+            if (pos < length) d = digitValue(text[pos].unicode());
+            if (d < 0) {
+                // 跳过数字之间的空白，空白之后仍是数字则视为同一个字面量
+                const int save = pos;
+                skipSpaces();
+                if (pos < length && pos != save) d = digitValue(text[pos].unicode());
+                if (d < 0) { pos = save; break; }
+            }
+            if (value > (limit - quint64(d)) / quint64(base)) overflow = true;
+            value = value * quint64(base) + quint64(d);
+            ++pos;
+        }
+        token.kind = TokNumber;
+        token.value = overflow ? 0 : qint64(value);
+        token.length = pos - token.pos;
+        return token;
+    }
+
+    ++pos;
+    switch (c) {
+    case 'x': case 'X': token.kind = TokVar; break;
+    case '(': token.kind = TokLParen; break;
+    case ')': token.kind = TokRParen; break;
+    case '+': token.kind = TokPlus; break;
+    case '-': token.kind = TokMinus; break;
+    case '*': token.kind = TokStar; break;
+    case '/': token.kind = TokSlash; break;
+    case '%': token.kind = TokPercent; break;
+    case '&': token.kind = TokAmp; break;
+    case '|': token.kind = TokPipe; break;
+    case '^': token.kind = TokCaret; break;
+    case '~': token.kind = TokTilde; break;
+    case '<':
+    case '>':
+        // 移位运算符必须是紧邻的 << 或 >>
+        if (pos < length && text[pos].unicode() == c) {
+            ++pos;
+            token.kind = c == '<' ? TokShl : TokShr;
+        } else {
+            token.kind = TokInvalid;
+        }
+        break;
+    default:
+        token.kind = TokInvalid;
+        break;
+    }
+    return token;
+}
+
+int binaryPrecedence(TokenKind kind)
+{
+    switch (kind) {
+    case TokShl: case TokShr: return 5;
+    case TokStar: case TokSlash: case TokPercent: return 4;
+    case TokPlus: case TokMinus: return 3;
+    case TokAmp: return 2;
+    case TokCaret: return 1;
+    case TokPipe: return 0;
+    default: return -1;
+    }
+}
+
+} // namespace calc
@@ -0,0 +1,62 @@
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <QStringView>
+
+#include "base.h"
+
+namespace calc {
+
+// -------------------------------
+// 词法单元类型
+// -------------------------------
+enum TokenKind : quint8 {
+    TokEnd,                                  // 输入结束
+    TokNumber,                               // 数字字面量，值在 Token::value 中
+    TokVar,                                  // 变量 x / X
+    TokLParen, TokRParen,
+    TokPlus, TokMinus, TokStar, TokSlash, TokPercent,
+    TokAmp, TokPipe, TokCaret, TokTilde,
+    TokShl, TokShr,
+    TokInvalid                               // 无法识别的字符（如单独的 < 或 >）
+};
+
+struct Token
+{
+    TokenKind kind = TokEnd;
+    int pos = 0;        // 在原始文本中的下标
+    qint64 value = 0;   // TokNumber 的值；超出 64 位有符号范围时为 0
+    int length = 0;     // TokNumber 在原始文本中的长度（含数字之间的空白）
+};
+
+// -------------------------------
+// 直接在 UTF-16 文本上切分词法单元，不复制、不分配内存
+// 数字按指定进制解析，数字之间的空白被忽略（与校验器去除空白后的视图一致）
+// -------------------------------
+class Tokenizer
+{
+public:
+    Tokenizer(QStringView text, int base);
+
+    Token next();
+
+    // 从 position 处继续切分（增量切分时跳过前面未改动的部分）
+    int position() const { return pos; }
+    void setPosition(int position);
+
+private:
+    int digitValue(ushort c) const;
+    void skipSpaces();
+
+    QStringView text;
+    int length;
+    int pos;
+    int base;
+};
+
+// 双目运算符的优先级，数值越大结合越紧；不是双目运算符时返回 -1
+int binaryPrecedence(TokenKind kind);
+
+} // namespace calc
+
+#endif // TOKENIZER_H
@@ -0,0 +1,181 @@
+#include "validator.h"
+
+#include <QChar>
+
+namespace calc {
+
+namespace {
+
+// -------------------------------
+// 字符分类表（ASCII），每个字符一组标志位
+// -------------------------------
+enum CharClass : quint16 {
+    ClassBin      = 1 << 0,  // 各进制下合法的数字
+    ClassOct      = 1 << 1,
+    ClassDec      = 1 << 2,
+    ClassHex      = 1 << 3,
+    ClassOperand  = 1 << 4,  // 任意进制都合法的非数字字符：运算符、括号、变量 x
+    ClassPairOp   = 1 << 5,  // 不能相邻、也不能开头的运算符：+ * / % & | ^ < >
+    ClassTrailOp  = 1 << 6,  // 不能结尾的运算符：+ - * / % & | ^ ~
+    ClassSpace    = 1 << 7
+};
+
+struct CharTable
+{
+    quint16 flags[128];
+
+    CharTable() : flags()
+    {
+        for (char c = '0'; c <= '1'; ++c) flags[int(c)] |= ClassBin;
+        for (char c = '0'; c <= '7'; ++c) flags[int(c)] |= ClassOct;
+        for (char c = '0'; c <= '9'; ++c) flags[int(c)] |= ClassDec | ClassHex;
+        for (char c = 'A'; c <= 'F'; ++c) flags[int(c)] |= ClassHex;
+        for (char c = 'a'; c <= 'f'; ++c) flags[int(c)] |= ClassHex;
+
+        for (const char *p = "+-*/%&|^~()<>xX"; *p; ++p) flags[int(*p)] |= ClassOperand;
+        for (const char *p = "+*/%&|^<>"; *p; ++p) flags[int(*p)] |= ClassPairOp;
+        for (const char *p = "+-*/%&|^~"; *p; ++p) flags[int(*p)] |= ClassTrailOp;
+        for (const char *p = " \t\n\v\f\r"; *p; ++p) flags[int(*p)] |= ClassSpace;
+    }
+};
+
+const CharTable charTable;
+
+inline quint16 digitClass(int base)
+{
+    switch (base) {
+    case BIN: return ClassBin;
+    case OCT: return ClassOct;
+    case HEX: return ClassHex;
+    default:  return ClassDec;
+    }
+}
+
+// 非 ASCII 字符只可能是空白（与移除 \s 的语义一致）或非法字符
+inline quint16 classify(ushort c)
+{
+    if (c < 128) return charTable.flags[c];
+    return QChar(c).isSpace() ? quint16(ClassSpace) : quint16(0);
+}
+
+// 记录某类错误第一次出现的位置
+inline void record(Validation (&found)[TrailingOperator + 1], ValidationError error, int column)
+{
+    if (found[error].error == NoError) {
+        found[error].error = error;
+        found[error].column = column;
+    }
+}
+
+// 连续运算符和除零在同一轮相邻检查中发现，先出现的一个生效
+inline void recordPair(Validation (&found)[TrailingOperator + 1], ValidationError error, int column)
+{
+    if (found[ConsecutiveOperators].error == NoError && found[DivisionByZero].error == NoError)
+        record(found, error, column);
+}
+
+// -------------------------------
+// 单遍扫描：跳过空白，逐字符更新括号深度和"前一个字符"状态
+// 各类错误各自记下首次出现的位置，最后按优先级报告，与逐项检查的结果一致
+// -------------------------------
+template<typename Char>
+Validation validateSpan(const Char *text, int length, int base)
+{
+    Validation found[TrailingOperator + 1];
+    const quint16 allowed = digitClass(base) | ClassOperand;
+
+    int depth = 0;             // 当前括号深度
+    int openAtTop = -1;        // 最近一个在深度 0 处打开的左括号，即最早未闭合的左括号
+    int count = 0;             // 非空白字符数
+    ushort prev = 0;           // 前一个非空白字符
+    quint16 prevFlags = 0;
+    int prevColumn = -1;
+    bool prevSkipped = false;  // 前一个字符是 << 或 >> 的后半，不参与相邻检查
+
+    for (int i = 0; i < length; ++i) {
+        const ushort c = ushort(text[i]);
+        const quint16 flags = classify(c);
+        if (flags & ClassSpace) continue;
+
+        if (c == '(') {
+            if (depth == 0) openAtTop = i;
+            ++depth;
+        } else if (c == ')') {
+            if (--depth < 0) record(found, TooManyRightParens, i);
+        }
+
+        if (!(flags & allowed)) record(found, IllegalCharacter, i);
+
+        if (count == 0) {
+            if (flags & ClassPairOp) record(found, LeadingOperator, i);
+        } else if (prevSkipped) {
+            prevSkipped = false;
+        } else if ((prev == '<' || prev == '>') && c == prev) {
+            prevSkipped = true;
+        } else if ((prevFlags & ClassPairOp) && (flags & ClassPairOp)) {
+            recordPair(found, ConsecutiveOperators, i);
+        } else if (prev == '/' && c == '0') {
+            recordPair(found, DivisionByZero, i);
+        }
+
+        prev = c;
+        prevFlags = flags;
+        prevColumn = i;
+        ++count;
+    }
+
+    if (count == 0) {
+        Validation empty;
+        empty.error = EmptyExpression;
+        empty.column = 0;
+        return empty;
+    }
+    if (depth > 0) record(found, TooManyLeftParens, openAtTop);
+    if (prevFlags & ClassTrailOp) record(found, TrailingOperator, prevColumn);
+
+    for (int e = TooManyRightParens; e <= TrailingOperator; ++e) {
+        if (found[e].error != NoError) return found[e];
+    }
+    return Validation();
+}
+
+} // namespace
+
+Validation validate(QStringView expr, int base)
+{
+    return validateSpan(expr.utf16(), int(expr.size()), base);
+}
+
+Validation validate(QLatin1String expr, int base)
+{
+    return validateSpan(reinterpret_cast<const uchar *>(expr.data()), int(expr.size()), base);
+}
+
+QString validationMessage(ValidationError error)
+{
+    switch (error) {
+    case NoError:              return QString();
+    case EmptyExpression:      return QStringLiteral("表达式为空");
+    case TooManyRightParens:   return QStringLiteral("括号不匹配：右括号过多");
+    case TooManyLeftParens:    return QStringLiteral("括号不匹配：左括号过多");
+    case IllegalCharacter:     return QStringLiteral("表达式包含非法字符");
+    case LeadingOperator:      return QStringLiteral("表达式不能以运算符开头");
+    case ConsecutiveOperators: return QStringLiteral("表达式包含连续的运算符");
+    case DivisionByZero:       return QStringLiteral("除数不得为0");
+    case TrailingOperator:     return QStringLiteral("表达式不能以运算符结尾");
+    }
+    return QString();
+}
+
+// -------------------------------
+// 表达式合法性检查
+// -------------------------------
+bool validateExpression(const QString &expr, int base, QString &errorMsg)
+{
+    const Validation result = validate(QStringView(expr), base);
+    if (result.ok()) return true;
+    errorMsg = validationMessage(result.error);
+    return false;
+}
+
+} // namespace calc
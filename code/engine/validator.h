@@ -0,0 +1,45 @@
+#ifndef VALIDATOR_H
+#define VALIDATOR_H
+
+#include <QLatin1String>
+#include <QString>
+#include <QStringView>
+
+#include "base.h"
+
+namespace calc {
+
+// 校验失败的原因，按报告优先级从高到低排列
+enum ValidationError {
+    NoError,
+    EmptyExpression,       // 表达式为空
+    TooManyRightParens,    // 括号不匹配：右括号过多
+    TooManyLeftParens,     // 括号不匹配：左括号过多
+    IllegalCharacter,      // 表达式包含非法字符
+    LeadingOperator,       // 表达式不能以运算符开头
+    ConsecutiveOperators,  // 表达式包含连续的运算符
+    DivisionByZero,        // 除数不得为0
+    TrailingOperator       // 表达式不能以运算符结尾
+};
+
+struct Validation
+{
+    ValidationError error = NoError;
+    int column = -1; // 出错字符在原始文本中的下标（含空白），通过时为 -1
+
+    bool ok() const { return error == NoError; }
+};
+
+// 单遍、无内存分配的表驱动校验，多个错误同时存在时按 ValidationError 的顺序报告
+Validation validate(QStringView expr, int base);
+Validation validate(QLatin1String expr, int base);
+
+// 错误原因对应的提示文本
+QString validationMessage(ValidationError error);
+
+// 检查表达式在指定进制下是否合法，不合法时通过 errorMsg 返回原因
+bool validateExpression(const QString &expr, int base, QString &errorMsg);
+
+} // namespace calc
+
+#endif // VALIDATOR_H
@@ -0,0 +1,184 @@
+#include "wideint.h"
+
+namespace calc {
+
+namespace {
+
+const int MaxLimbs = MaxValueBits / 64;
+
+// a * b + c + carry 的低 64 位，高 64 位写回 carry（结果不会超出 128 位）
+inline quint64 mulAddCarry(quint64 a, quint64 b, quint64 c, quint64 &carry)
+{
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 product = static_cast<unsigned __int128>(a) * b + c + carry;
+    carry = quint64(product >> 64);
+    return quint64(product);
+#else
+    const quint64 aLow = a & 0xFFFFFFFF, aHigh = a >> 32;
+    const quint64 bLow = b & 0xFFFFFFFF, bHigh = b >> 32;
+    const quint64 ll = aLow * bLow, lh = aLow * bHigh, hl = aHigh * bLow, hh = aHigh * bHigh;
+    const quint64 middle = (ll >> 32) + (lh & 0xFFFFFFFF) + (hl & 0xFFFFFFFF);
+    quint64 low = (ll & 0xFFFFFFFF) | (middle << 32);
+    quint64 high = hh + (lh >> 32) + (hl >> 32) + (middle >> 32);
+    low += c;
+    high += low < c;
+    low += carry;
+    high += low < carry;
+    carry = high;
+    return low;
+#endif
+}
+
+// 拆成 32 位一位的数字，返回去掉高位 0 后的位数
+int toDigits(const quint64 *value, int n, quint32 *digits)
+{
+    for (int i = 0; i < n; ++i) {
+        digits[2 * i] = quint32(value[i]);
+        digits[2 * i + 1] = quint32(value[i] >> 32);
+    }
+    int count = 2 * n;
+    while (count > 0 && digits[count - 1] == 0) --count;
+    return count;
+}
+
+void fromDigits(const quint32 *digits, int count, quint64 *value, int n)
+{
+    for (int i = 0; i < n; ++i) {
+        const quint64 low = 2 * i < count ? digits[2 * i] : 0;
+        const quint64 high = 2 * i + 1 < count ? digits[2 * i + 1] : 0;
+        value[i] = low | (high << 32);
+    }
+}
+
+inline int leadingZeros32(quint32 value)
+{
+    int zeros = 0;
+    while (!(value & 0x80000000u)) {
+        value <<= 1;
+        ++zeros;
+    }
+    return zeros;
+}
+
+} // namespace
+
+int bitLength(quint64 value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return value ? 64 - __builtin_clzll(value) : 1;
+#else
+    int bits = 1;
+    while (value >>= 1) ++bits;
+    return bits;
+#endif
+}
+
+namespace limbs {
+
+void mul(quint64 *out, const quint64 *a, const quint64 *b, int n)
+{
+    // 只计算落在低 n 块内的部分积
+    quint64 result[MaxLimbs] = {};
+    for (int i = 0; i < n; ++i) {
+        if (!a[i]) continue;
+        quint64 carry = 0;
+        for (int j = 0; i + j < n; ++j) result[i + j] = mulAddCarry(a[i], b[j], result[i + j], carry);
+    }
+    for (int i = 0; i < n; ++i) out[i] = result[i];
+}
+
+quint64 mulAdd(quint64 *a, int n, quint64 m, quint64 add)
+{
+    quint64 carry = add;
+    for (int i = 0; i < n; ++i) a[i] = mulAddCarry(a[i], m, 0, carry);
+    return carry;
+}
+
+// 以 32 位为一位做长除法（Hacker's Delight 的 divmnu），只用 64 位乘除，不依赖 128 位类型
+void divmod(const quint64 *a, const quint64 *b, int n, quint64 *quotient, quint64 *remainder)
+{
+    quint32 u[2 * MaxLimbs + 1], v[2 * MaxLimbs], q[2 * MaxLimbs] = {};
+    const int m = toDigits(a, n, u);
+    const int d = toDigits(b, n, v);
+    Q_ASSERT(d > 0);
+
+    if (m < d) {
+        if (quotient) fromDigits(q, 0, quotient, n);
+        if (remainder) fromDigits(u, m, remainder, n);
+        return;
+    }
+
+    if (d == 1) {
+        // 除数只有一位：逐位短除
+        quint64 rest = 0;
+        for (int j = m - 1; j >= 0; --j) {
+            const quint64 current = (rest << 32) | u[j];
+            q[j] = quint32(current / v[0]);
+            rest = current % v[0];
+        }
+        if (quotient) fromDigits(q, m, quotient, n);
+        if (remainder) {
+            const quint32 r[1] = {quint32(rest)};
+            fromDigits(r, 1, remainder, n);
+        }
+        return;
+    }
+
+    // 规格化：左移使除数最高位为 1，被除数多出一位
+    const int s = leadingZeros32(v[d - 1]);
+    quint32 vn[2 * MaxLimbs], un[2 * MaxLimbs + 1];
+    for (int i = d - 1; i > 0; --i) vn[i] = quint32(((quint64(v[i]) << 32) | v[i - 1]) >> (32 - s));
+    vn[0] = v[0] << s;
+    un[m] = quint32(quint64(u[m - 1]) >> (32 - s));
+    for (int i = m - 1; i > 0; --i) un[i] = quint32(((quint64(u[i]) << 32) | u[i - 1]) >> (32 - s));
+    un[0] = u[0] << s;
+
+    const quint64 base = quint64(1) << 32;
+    for (int j = m - d; j >= 0; --j) {
+        // 用最高两位估计商的这一位，最多偏大 2
+        const quint64 top = (quint64(un[j + d]) << 32) | un[j + d - 1];
+        quint64 qhat = top / vn[d - 1];
+        quint64 rhat = top % vn[d - 1];
+        while (qhat >= base || qhat * vn[d - 2] > ((rhat << 32) | un[j + d - 2])) {
+            --qhat;
+            rhat += vn[d - 1];
+            if (rhat >= base) break;
+        }
+
+        // 减去 qhat * 除数
+        qint64 borrow = 0;
+        qint64 t;
+        for (int i = 0; i < d; ++i) {
+            const quint64 product = qhat * vn[i];
+            t = qint64(un[i + j]) - borrow - qint64(product & 0xFFFFFFFF);
+            un[i + j] = quint32(t);
+            borrow = qint64(product >> 32) - (t >> 32);
+        }
+        t = qint64(un[j + d]) - borrow;
+        un[j + d] = quint32(t);
+
+        q[j] = quint32(qhat);
+        if (t < 0) {
+            // 估计偏大，加回一次除数
+            --q[j];
+            quint64 carry = 0;
+            for (int i = 0; i < d; ++i) {
+                const quint64 sum = quint64(un[i + j]) + vn[i] + carry;
+                un[i + j] = quint32(sum);
+                carry = sum >> 32;
+            }
+            un[j + d] = quint32(un[j + d] + carry);
+        }
+    }
+
+    if (quotient) fromDigits(q, m - d + 1, quotient, n);
+    if (remainder) {
+        quint32 r[2 * MaxLimbs];
+        for (int i = 0; i < d; ++i) r[i] = quint32(((quint64(un[i + 1]) << 32) | un[i]) >> s);
+        fromDigits(r, d, remainder, n);
+    }
+}
+
+} // namespace limbs
+
+} // namespace calc
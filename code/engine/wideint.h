@@ -0,0 +1,302 @@
+#ifndef WIDEINT_H
+#define WIDEINT_H
+
+#include <QtGlobal>
+
+#include "ops.h"
+
+namespace calc {
+
+// 支持的数值位宽：64 位为原生整数，128/256/512 位为 WideInt
+const int MaxValueBits = 512;
+
+inline bool isValueBits(int bits)
+{
+    return bits == 64 || bits == 128 || bits == 256 || bits == 512;
+}
+
+// 数值的二进制位数（按 64 位无符号），0 记为 1 位，与 QString::number(value, 2) 的长度一致
+int bitLength(quint64 value);
+
+// -------------------------------
+// 按 64 位分块、低位在前的无符号运算，n 为块数（不超过 MaxValueBits / 64），结果按 n 块截断
+// -------------------------------
+namespace limbs {
+
+// out = a * b，out 可以与 a 或 b 相同
+void mul(quint64 *out, const quint64 *a, const quint64 *b, int n);
+
+// a = a * m + add，返回溢出到第 n 块之外的部分
+quint64 mulAdd(quint64 *a, int n, quint64 m, quint64 add);
+
+// 无符号除法（Knuth 算法 D），b 不得为 0；quotient、remainder 可以为空
+void divmod(const quint64 *a, const quint64 *b, int n, quint64 *quotient, quint64 *remainder);
+
+} // namespace limbs
+
+// -------------------------------
+// 定宽整数：Bits 位补码，按块逐位传播进位；Bits 须为 64 的倍数
+// 运算语义与 ops 中的 64 位运算一致（回绕、除数为 0 得 0、移位饱和）
+// Bits 为 64 时 ops 的运算直接转到原生 qint64 实现
+// -------------------------------
+template<int Bits>
+struct WideInt
+{
+    Q_STATIC_ASSERT_X(Bits >= 64 && Bits <= MaxValueBits && Bits % 64 == 0, "WideInt 的位宽须为 64 的倍数");
+    enum { Limbs = Bits / 64 };
+
+    quint64 limb[Limbs];  // 低位在前
+
+    WideInt() { for (int i = 0; i < Limbs; ++i) limb[i] = 0; }
+
+    // 符号扩展
+    static WideInt fromInt64(qint64 value)
+    {
+        WideInt result;
+        result.limb[0] = quint64(value);
+        for (int i = 1; i < Limbs; ++i) result.limb[i] = value < 0 ? ~quint64(0) : 0;
+        return result;
+    }
+
+    static WideInt fromUInt64(quint64 value)
+    {
+        WideInt result;
+        result.limb[0] = value;
+        return result;
+    }
+
+    quint64 low64() const { return limb[0]; }
+    bool isNegative() const { return qint64(limb[Limbs - 1]) < 0; }
+
+    bool isZero() const
+    {
+        for (int i = 0; i < Limbs; ++i) {
+            if (limb[i]) return false;
+        }
+        return true;
+    }
+
+    // 是否等于低 64 位的符号扩展，即能无损转成 qint64
+    bool fitsInt64() const
+    {
+        const quint64 fill = qint64(limb[0]) < 0 ? ~quint64(0) : 0;
+        for (int i = 1; i < Limbs; ++i) {
+            if (limb[i] != fill) return false;
+        }
+        return true;
+    }
+
+    // 按 Bits 位无符号的二进制位数，0 记为 1 位
+    int bitLength() const
+    {
+        for (int i = Limbs - 1; i > 0; --i) {
+            if (limb[i]) return 64 * i + calc::bitLength(limb[i]);
+        }
+        return calc::bitLength(limb[0]);
+    }
+
+    WideInt &operator&=(const WideInt &other) { for (int i = 0; i < Limbs; ++i) limb[i] &= other.limb[i]; return *this; }
+    WideInt &operator|=(const WideInt &other) { for (int i = 0; i < Limbs; ++i) limb[i] |= other.limb[i]; return *this; }
+    WideInt &operator^=(const WideInt &other) { for (int i = 0; i < Limbs; ++i) limb[i] ^= other.limb[i]; return *this; }
+};
+
+template<int Bits>
+inline WideInt<Bits> operator~(const WideInt<Bits> &value)
+{
+    WideInt<Bits> result;
+    for (int i = 0; i < WideInt<Bits>::Limbs; ++i) result.limb[i] = ~value.limb[i];
+    return result;
+}
+
+template<int Bits>
+inline bool operator==(const WideInt<Bits> &a, const WideInt<Bits> &b)
+{
+    for (int i = 0; i < WideInt<Bits>::Limbs; ++i) {
+        if (a.limb[i] != b.limb[i]) return false;
+    }
+    return true;
+}
+
+template<int Bits>
+inline bool operator!=(const WideInt<Bits> &a, const WideInt<Bits> &b) { return !(a == b); }
+
+// 左移 count 位，0 <= count < Bits
+template<int Bits>
+WideInt<Bits> shiftLeft(const WideInt<Bits> &value, int count)
+{
+    WideInt<Bits> result;
+    const int whole = count / 64;
+    const int part = count % 64;
+    for (int i = WideInt<Bits>::Limbs - 1; i >= whole; --i) {
+        quint64 limb = value.limb[i - whole] << part;
+        if (part && i > whole) limb |= value.limb[i - whole - 1] >> (64 - part);
+        result.limb[i] = limb;
+    }
+    return result;
+}
+
+// 右移 count 位，0 <= count < Bits；arithmetic 为真时高位按符号位填充
+template<int Bits>
+WideInt<Bits> shiftRight(const WideInt<Bits> &value, int count, bool arithmetic)
+{
+    const int limbCount = WideInt<Bits>::Limbs;
+    const quint64 fill = arithmetic && value.isNegative() ? ~quint64(0) : 0;
+    const int whole = count / 64;
+    const int part = count % 64;
+    WideInt<Bits> result;
+    for (int i = 0; i < limbCount; ++i) {
+        const quint64 low = i + whole < limbCount ? value.limb[i + whole] : fill;
+        const quint64 high = i + whole + 1 < limbCount ? value.limb[i + whole + 1] : fill;
+        result.limb[i] = part ? (low >> part) | (high << (64 - part)) : low;
+    }
+    return result;
+}
+
+// 低 width 位为 1 的掩码，width >= Bits 时全为 1
+template<int Bits>
+WideInt<Bits> lowBitsMask(int width)
+{
+    WideInt<Bits> mask;
+    for (int i = 0; i < WideInt<Bits>::Limbs; ++i) {
+        const int bits = width - 64 * i;
+        mask.limb[i] = bits >= 64 ? ~quint64(0) : bits > 0 ? (quint64(1) << bits) - 1 : 0;
+    }
+    return mask;
+}
+
+// 位宽转换：变窄时截断，变宽时按符号位扩展
+template<int To, int From>
+WideInt<To> widthCast(const WideInt<From> &value)
+{
+    WideInt<To> result;
+    const quint64 fill = value.isNegative() ? ~quint64(0) : 0;
+    for (int i = 0; i < WideInt<To>::Limbs; ++i) result.limb[i] = i < WideInt<From>::Limbs ? value.limb[i] : fill;
+    return result;
+}
+
+// -------------------------------
+// 与 ops.h 中 64 位运算语义一致的宽整数运算
+// -------------------------------
+namespace ops {
+
+template<int Bits>
+WideInt<Bits> add(const WideInt<Bits> &a, const WideInt<Bits> &b)
+{
+    WideInt<Bits> result;
+    quint64 carry = 0;
+    for (int i = 0; i < WideInt<Bits>::Limbs; ++i) {
+        const quint64 sum = a.limb[i] + carry;
+        carry = sum < carry;
+        result.limb[i] = sum + b.limb[i];
+        carry += result.limb[i] < sum;
+    }
+    return result;
+}
+
+template<int Bits>
+WideInt<Bits> sub(const WideInt<Bits> &a, const WideInt<Bits> &b)
+{
+    WideInt<Bits> result;
+    quint64 borrow = 0;
+    for (int i = 0; i < WideInt<Bits>::Limbs; ++i) {
+        const quint64 diff = a.limb[i] - borrow;
+        borrow = diff > a.limb[i];
+        result.limb[i] = diff - b.limb[i];
+        borrow += result.limb[i] > diff;
+    }
+    return result;
+}
+
+template<int Bits>
+WideInt<Bits> neg(const WideInt<Bits> &a)
+{
+    return sub(WideInt<Bits>(), a);
+}
+
+template<int Bits>
+WideInt<Bits> mul(const WideInt<Bits> &a, const WideInt<Bits> &b)
+{
+    WideInt<Bits> result;
+    limbs::mul(result.limb, a.limb, b.limb, WideInt<Bits>::Limbs);
+    return result;
+}
+
+// 按绝对值做无符号除法再定符号：商向零截断，余数与被除数同号；最小值除以 -1 自然回绕
+template<int Bits>
+WideInt<Bits> div(const WideInt<Bits> &a, const WideInt<Bits> &b)
+{
+    WideInt<Bits> quotient;
+    if (b.isZero()) return quotient;
+    const WideInt<Bits> dividend = a.isNegative() ? neg(a) : a;
+    const WideInt<Bits> divisor = b.isNegative() ? neg(b) : b;
+    limbs::divmod(dividend.limb, divisor.limb, WideInt<Bits>::Limbs, quotient.limb, nullptr);
+    return a.isNegative() != b.isNegative() ? neg(quotient) : quotient;
+}
+
+template<int Bits>
+WideInt<Bits> mod(const WideInt<Bits> &a, const WideInt<Bits> &b)
+{
+    WideInt<Bits> remainder;
+    if (b.isZero()) return remainder;
+    const WideInt<Bits> dividend = a.isNegative() ? neg(a) : a;
+    const WideInt<Bits> divisor = b.isNegative() ? neg(b) : b;
+    limbs::divmod(dividend.limb, divisor.limb, WideInt<Bits>::Limbs, nullptr, remainder.limb);
+    return a.isNegative() ? neg(remainder) : remainder;
+}
+
+// 移位位数不在 [0, Bits) 内（含负数）时按逻辑结果饱和，与 64 位一致
+template<int Bits>
+int shiftCount(const WideInt<Bits> &b)
+{
+    for (int i = 1; i < WideInt<Bits>::Limbs; ++i) {
+        if (b.limb[i]) return -1;
+    }
+    return b.limb[0] < quint64(Bits) ? int(b.limb[0]) : -1;
+}
+
+template<int Bits>
+WideInt<Bits> shl(const WideInt<Bits> &a, const WideInt<Bits> &b)
+{
+    const int count = shiftCount(b);
+    return count >= 0 ? shiftLeft(a, count) : WideInt<Bits>();
+}
+
+template<int Bits>
+WideInt<Bits> shr(const WideInt<Bits> &a, const WideInt<Bits> &b)
+{
+    const int count = shiftCount(b);
+    if (count >= 0) return shiftRight(a, count, true);
+    return a.isNegative() ? ~WideInt<Bits>() : WideInt<Bits>();
+}
+
+// 64 位：直接使用原生运算，不经过分块循环和长除法
+inline WideInt<64> mul(const WideInt<64> &a, const WideInt<64> &b)
+{
+    return WideInt<64>::fromInt64(mul(qint64(a.limb[0]), qint64(b.limb[0])));
+}
+
+inline WideInt<64> div(const WideInt<64> &a, const WideInt<64> &b)
+{
+    return WideInt<64>::fromInt64(div(qint64(a.limb[0]), qint64(b.limb[0])));
+}
+
+inline WideInt<64> mod(const WideInt<64> &a, const WideInt<64> &b)
+{
+    return WideInt<64>::fromInt64(mod(qint64(a.limb[0]), qint64(b.limb[0])));
+}
+
+inline WideInt<64> shl(const WideInt<64> &a, const WideInt<64> &b)
+{
+    return WideInt<64>::fromInt64(shl(qint64(a.limb[0]), qint64(b.limb[0])));
+}
+
+inline WideInt<64> shr(const WideInt<64> &a, const WideInt<64> &b)
+{
+    return WideInt<64>::fromInt64(shr(qint64(a.limb[0]), qint64(b.limb[0])));
+}
+
+} // namespace ops
+
+} // namespace calc
+
+#endif // WIDEINT_H
@@ -0,0 +1,66 @@
+#include "widevalue.h"
+
+namespace calc {
+
+namespace {
+
+template<int Bits>
+ParsedWideNumber<MaxValueBits> widen(const ParsedWideNumber<Bits> &parsed)
+{
+    ParsedWideNumber<MaxValueBits> result;
+    result.value = widthCast<MaxValueBits>(parsed.value);
+    result.overflow = parsed.overflow;
+    result.errorPos = parsed.errorPos;
+    result.empty = parsed.empty;
+    return result;
+}
+
+template<int Bits>
+WideValue executeAt(const Program &program, const WideValue &x)
+{
+    return widthCast<MaxValueBits>(execute(program, widthCast<Bits>(x)));
+}
+
+} // namespace
+
+ParsedWideNumber<MaxValueBits> parseNumber(QStringView text, int base, int valueBits)
+{
+    switch (valueBits) {
+    case 128: return widen(parseNumber<128>(text, base));
+    case 256: return widen(parseNumber<256>(text, base));
+    case 512: return parseNumber<512>(text, base);
+    default: return widen(parseNumber<64>(text, base));
+    }
+}
+
+void formatDisplay(const WideValue &value, int valueBits, const SplitLayout &layout, DisplayStrings &out)
+{
+    switch (valueBits) {
+    case 128: formatDisplay(widthCast<128>(value), layout, out); break;
+    case 256: formatDisplay(widthCast<256>(value), layout, out); break;
+    case 512: formatDisplay(value, layout, out); break;
+    default: formatDisplay(qint64(value.low64()), layout, out); break;
+    }
+}
+
+void formatValues(const WideValue &value, int valueBits, DisplayStrings &out)
+{
+    switch (valueBits) {
+    case 128: formatValues(widthCast<128>(value), out); break;
+    case 256: formatValues(widthCast<256>(value), out); break;
+    case 512: formatValues(value, out); break;
+    default: formatValues(qint64(value.low64()), out); break;
+    }
+}
+
+WideValue execute(const Program &program, const WideValue &x, int valueBits)
+{
+    switch (valueBits) {
+    case 128: return executeAt<128>(program, x);
+    case 256: return executeAt<256>(program, x);
+    case 512: return executeAt<512>(program, x);
+    default: return WideValue::fromInt64(execute(program, qint64(x.low64())));
+    }
+}
+
+} // namespace calc
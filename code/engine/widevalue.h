@@ -0,0 +1,54 @@
+#ifndef WIDEVALUE_H
+#define WIDEVALUE_H
+
+#include <QStringView>
+
+#include "bytecode.h"
+#include "format.h"
+#include "radix.h"
+#include "wideint.h"
+
+namespace calc {
+
+// -------------------------------
+// 运行时选择位宽（64/128/256/512）的数值，供图形界面这类在运行中切换位宽的调用方使用
+// 数值统一存为按当前位宽符号扩展的 512 位整数，下面的函数按 valueBits 分派到对应的 WideInt<Bits> 实现
+// valueBits 不是受支持的位宽时按 64 位处理
+// -------------------------------
+typedef WideInt<MaxValueBits> WideValue;
+
+// 容纳 bits 位分割规则的最小位宽，超过 MaxValueBits 时返回 0
+inline int valueBitsFor(int bits)
+{
+    for (int valueBits = 64; valueBits <= MaxValueBits; valueBits *= 2) {
+        if (bits <= valueBits) return valueBits;
+    }
+    return 0;
+}
+
+// 截到 valueBits 位并符号扩展，即换成 valueBits 位补码后的值
+inline WideValue truncateTo(const WideValue &value, int valueBits)
+{
+    const int shift = MaxValueBits - valueBits;
+    return shift > 0 ? shiftRight(shiftLeft(value, shift), shift, true) : value;
+}
+
+// 按 valueBits 位无符号的二进制位数（负数即 valueBits），与分割布局中的 valueBits 参数一致
+inline int bitLength(const WideValue &value, int valueBits)
+{
+    return value.isNegative() ? valueBits : value.bitLength();
+}
+
+// 按 valueBits 位解析，溢出的判定同 parseNumber<Bits>
+ParsedWideNumber<MaxValueBits> parseNumber(QStringView text, int base, int valueBits);
+
+// formatDisplay / formatValues 的 valueBits 位版本
+void formatDisplay(const WideValue &value, int valueBits, const SplitLayout &layout, DisplayStrings &out);
+void formatValues(const WideValue &value, int valueBits, DisplayStrings &out);
+
+// 按 valueBits 位执行，program 应以同一位宽编译（ProgramCache::get(expr, base, valueBits)）
+WideValue execute(const Program &program, const WideValue &x, int valueBits);
+
+} // namespace calc
+
+#endif // WIDEVALUE_H
@@ -0,0 +1,69 @@
+#include "evaluator.h"
+
+#include "trace.h"
+
+ExpressionEvaluator::ExpressionEvaluator(QObject *parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<calc::Evaluation>();
+    for (std::atomic<quint64> &generation : latest) generation.store(0);
+
+    worker.moveToThread(&thread);
+    thread.setObjectName(QStringLiteral("evaluator"));
+    thread.start();
+}
+
+ExpressionEvaluator::~ExpressionEvaluator()
+{
+    // 作废排队中的请求，等正在执行的一个结束
+    cancel(Preview);
+    cancel(Commit);
+    thread.quit();
+    thread.wait();
+}
+
+quint64 ExpressionEvaluator::submit(Kind kind, const QString &expr, int base, int valueBits, const calc::WideValue &x)
+{
+    Request request;
+    request.kind = kind;
+    request.generation = ++latest[kind];
+    request.expr = expr;
+    request.base = base;
+    request.valueBits = valueBits;
+    request.x = x;
+
+    QMetaObject::invokeMethod(&worker, [this, request]() { run(request); }, Qt::QueuedConnection);
+    return request.generation;
+}
+
+void ExpressionEvaluator::cancel(Kind kind)
+{
+    ++latest[kind];
+}
+
+bool ExpressionEvaluator::isCurrent(Kind kind, quint64 generation) const
+{
+    return latest[kind].load() == generation;
+}
+
+// -------------------------------
+// 工作线程：连续按键时排队的请求只有最后一个真正执行
+// -------------------------------
+void ExpressionEvaluator::run(const Request &request)
+{
+    if (!isCurrent(request.kind, request.generation)) return;
+    TRACE_SCOPE("evaluate");
+
+    calc::Evaluation result;
+    if (request.kind == Preview) {
+        // 增量切分之后、求值之前再检查一次：切分总会完成，作废的请求不再解析
+        live.setText(QStringView(request.expr), request.base);
+        if (!isCurrent(request.kind, request.generation)) return;
+        result = live.evaluate(request.valueBits, request.x);
+    } else {
+        result = cache.evaluate(QStringView(request.expr), request.base, request.valueBits, request.x);
+    }
+
+    if (!isCurrent(request.kind, request.generation)) return;
+    emit evaluated(request.generation, request.kind, result);
+}
@@ -0,0 +1,68 @@
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include <QMetaType>
+#include <QObject>
+#include <QString>
+#include <QThread>
+
+#include <atomic>
+
+#include "evalcache.h"
+#include "liveexpr.h"
+
+Q_DECLARE_METATYPE(calc::Evaluation)
+
+// -------------------------------
+// 后台求值：表达式的校验和计算在工作线程中进行，界面线程只提交请求、接收结果，不等待引擎
+// 实时预览与按"="各有一个代号计数器，每次提交加一；新的提交使同类中更早的请求作废：
+// 排队中的旧请求不再执行，正在执行的在两个阶段之间放弃，已经发出的结果由接收方用 isCurrent 丢弃
+// 结果通过排队连接的 evaluated 信号送回界面线程
+// 求值缓存和实时预览的增量状态只在工作线程中访问
+// -------------------------------
+class ExpressionEvaluator : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Kind {
+        Preview,  // 实时预览：增量求值
+        Commit    // 按"="：经过求值缓存
+    };
+
+    explicit ExpressionEvaluator(QObject *parent = nullptr);
+    ~ExpressionEvaluator() override;
+
+    // 提交一次求值，返回它的代号；x 为变量 x 的取值
+    quint64 submit(Kind kind, const QString &expr, int base, int valueBits, const calc::WideValue &x);
+
+    // 作废该类所有未完成的求值（如关闭预览、清空）
+    void cancel(Kind kind);
+
+    // 结果是否来自该类最近一次提交
+    bool isCurrent(Kind kind, quint64 generation) const;
+
+signals:
+    void evaluated(quint64 generation, int kind, const calc::Evaluation &result);
+
+private:
+    struct Request
+    {
+        Kind kind;
+        quint64 generation;
+        QString expr;
+        int base;
+        int valueBits;
+        calc::WideValue x;
+    };
+
+    void run(const Request &request); // 在工作线程中执行
+
+    QThread thread;
+    QObject worker;                       // 属于工作线程，提交的请求在它的事件循环中依次执行
+    std::atomic<quint64> latest[Commit + 1];
+    calc::EvaluationCache cache;          // 以下只在工作线程中访问
+    calc::LiveExpression live;
+};
+
+#endif // EVALUATOR_H
@@ -1,23 +1,94 @@
 #include "mainwindow.h"
+#include "trace.h"
 
 #include <QApplication>
 #include <QLocale>
 #include <QTranslator>
 
+#include <cstring>
+
+namespace {
+
+// 开启跟踪时，按键、鼠标和重绘等事件的分发耗时也写入跟踪，槽函数的区间嵌套在其中
+// --profile-startup 时在第一次绘制完成后输出各阶段耗时并退出
+class Application : public QApplication
+{
+public:
+    using QApplication::QApplication;
+
+    bool notify(QObject *receiver, QEvent *event) override
+    {
+        if (trace::profiling()) return notifyProfiling(receiver, event);
+        if (trace::enabled()) {
+            if (const char *name = trace::eventName(event->type())) {
+                trace::Scope scope(name);
+                return QApplication::notify(receiver, event);
+            }
+        }
+        return QApplication::notify(receiver, event);
+    }
+
+private:
+    bool notifyProfiling(QObject *receiver, QEvent *event)
+    {
+        const QEvent::Type type = event->type();
+        trace::Scope scope(trace::eventName(type));
+        const bool result = QApplication::notify(receiver, event);
+
+        // 窗口第一次曝光或重绘处理完，即已画出首帧、可以响应输入
+        if (!firstFrame && (type == QEvent::Expose || type == QEvent::UpdateRequest)) {
+            firstFrame = true;
+            trace::phase("first frame");
+            trace::reportProfile();
+            quit();
+        }
+        return result;
+    }
+
+    bool firstFrame = false;
+};
+
+bool hasArgument(int argc, char *argv[], const char *name)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], name)) return true;
+    }
+    return false;
+}
+
+// --trace <文件> 优先，其次是环境变量 CAL_TRACE
+QString tracePath(int argc, char *argv[])
+{
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (!strcmp(argv[i], "--trace")) return QString::fromLocal8Bit(argv[i + 1]);
+    }
+    return QString::fromLocal8Bit(qgetenv("CAL_TRACE"));
+}
+
+} // namespace
+
 int main(int argc, char *argv[])
 {
-    QApplication a(argc, argv);
+    if (hasArgument(argc, argv, "--profile-startup")) trace::startProfile();
+    const QString traceOutput = tracePath(argc, argv);
+    if (!traceOutput.isEmpty()) trace::enable(traceOutput);
+
+    Application a(argc, argv);
+    trace::phase("QApplication");
 
+    // 由 Qt 按系统的界面语言依次查找 :/i18n/cal_<语言>.qm，空的翻译不安装
     QTranslator translator;
-    const QStringList uiLanguages = QLocale::system().uiLanguages();
-    for (const QString &locale : uiLanguages) {
-        const QString baseName = "cal_" + QLocale(locale).name();
-        if (translator.load(":/i18n/" + baseName)) {
-            a.installTranslator(&translator);
-            break;
-        }
+    if (translator.load(QLocale(), "cal", "_", ":/i18n") && !translator.isEmpty()) {
+        a.installTranslator(&translator);
     }
+    trace::phase("translator");
+
     MainWindow w;
     w.show();
-    return a.exec();
+    trace::phase("show");
+
+    const int code = a.exec();
+
+    trace::dumpIfEnabled();
+    return code;
 }
@@ -5,11 +5,13 @@
 #include <QKeyEvent>
 #include <QApplication>
 #include <QDebug>
-#include <QRegularExpression>
-#include <QRegularExpressionValidator>
 #include <QResizeEvent>
 #include <QLabel>
 #include <QCheckBox>
+#include <QTimer>
+
+#include "charsetvalidator.h"
+#include "trace.h"
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -18,8 +20,16 @@ MainWindow::MainWindow(QWidget *parent)
     , lastFocusedEdit(nullptr)
     , isUpdating(false)
     , lastUpdateMode(0) // 默认仅更新数值
+    , evaluator(nullptr)
+    , busyTimer(nullptr)
+    , commitPending(false)
+    , rescaleTimer(nullptr)
+    , appliedPointSize(0)
+    , appliedButtonHeight(0)
+    , styledBase(0)
 {
     ui->setupUi(this);
+    trace::phase("setupUi");
 
     // 1. 初始化数字按钮映射
     digitButtons = {
@@ -39,35 +49,27 @@ MainWindow::MainWindow(QWidget *parent)
         {"<<", ui->btnShl}, {">>", ui->btnShr}
     };
 
-    // 3. 设置输入校验，禁止非法键盘输入
-    // 表达式：允许 0-9 A-F a-f、空格和常用运算符
-    ui->editExpression->setValidator(new QRegularExpressionValidator(
-                                         QRegularExpression("[0-9A-Fa-f\\s\\+\\-\\*/%&|^~()<>]*"), this));
-
+    // 3. 设置输入校验，禁止非法键盘输入（按字符集逐字符检查，不编译正则）
+    // 表达式：允许 0-9 A-F a-f、变量 x（当前值）、空白和常用运算符
+    ui->editExpression->setValidator(new CharSetValidator("0123456789ABCDEFabcdefxX+-*/%&|^~()<>",
+                                                          CharSetValidator::AllowSpace, this));
     // HEX: 0-9 A-F a-f
-    ui->editHex->setValidator(new QRegularExpressionValidator(
-                                  QRegularExpression("[0-9A-Fa-f]*"), this));
+    ui->editHex->setValidator(new CharSetValidator("0123456789ABCDEFabcdef", CharSetValidator::NoOption, this));
     // DEC: 可选负号 + 数字
-    ui->editDec->setValidator(new QRegularExpressionValidator(
-                                  QRegularExpression("-?[0-9]*"), this));
+    ui->editDec->setValidator(new CharSetValidator("0123456789", CharSetValidator::LeadingMinus, this));
     // OCT: 0-7
-    ui->editOct->setValidator(new QRegularExpressionValidator(
-                                  QRegularExpression("[0-7]*"), this));
+    ui->editOct->setValidator(new CharSetValidator("01234567", CharSetValidator::NoOption, this));
     // BIN: 0/1
-    ui->editBin->setValidator(new QRegularExpressionValidator(
-                                  QRegularExpression("[01]*"), this));
+    ui->editBin->setValidator(new CharSetValidator("01", CharSetValidator::NoOption, this));
     // BIN 结果: 0/1 和分段分隔符 |
-    ui->editBinResult->setValidator(new QRegularExpressionValidator(
-                                        QRegularExpression("[01|]*"), this));
+    ui->editBinResult->setValidator(new CharSetValidator("01|", CharSetValidator::NoOption, this));
     // DEC 结果: 数字和分隔符 |
-    ui->editDecResult->setValidator(new QRegularExpressionValidator(
-                                        QRegularExpression("[0-9|]*"), this));
+    ui->editDecResult->setValidator(new CharSetValidator("0123456789|", CharSetValidator::NoOption, this));
     // HEX 结果: 0-9 A-F a-f 和分隔符 |
-    ui->editHexResult->setValidator(new QRegularExpressionValidator(
-                                        QRegularExpression("[0-9A-Fa-f|]*"), this));
+    ui->editHexResult->setValidator(new CharSetValidator("0123456789ABCDEFabcdef|", CharSetValidator::NoOption, this));
     // 分割规则: 数字和逗号
-    ui->editSplitRule->setValidator(new QRegularExpressionValidator(
-                                        QRegularExpression("[0-9,]*"), this));
+    ui->editSplitRule->setValidator(new CharSetValidator("0123456789,", CharSetValidator::NoOption, this));
+    trace::phase("validators");
 
     // 3. 信号槽连接
     for(auto btn : digitButtons.values())
@@ -112,10 +114,42 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->chkSyncExpression, &QCheckBox::stateChanged,
             this, &MainWindow::onUpdateModeChanged);
 
+    // 表达式在工作线程中求值，结果经排队连接送回
+    evaluator = new ExpressionEvaluator(this);
+    connect(evaluator, &ExpressionEvaluator::evaluated, this, &MainWindow::onExpressionEvaluated, Qt::QueuedConnection);
+    busyTimer = new QTimer(this);
+    busyTimer->setSingleShot(true);
+    busyTimer->setInterval(100);
+    connect(busyTimer, &QTimer::timeout, this, [this]() { showStatus(QStringLiteral("计算中…"), false); });
+
+    // 表达式边输入边预览结果；勾选状态变化时立即刷新或清空预览
+    connect(ui->editExpression, &QLineEdit::textChanged, this, &MainWindow::onEditChanged);
+    connect(ui->chkLivePreview, &QCheckBox::stateChanged, this, &MainWindow::updatePreview);
+
+    // 9. 窗口缩放：一次性收集需要缩放的控件，按钮的尺寸策略固定不变
+    for (QLineEdit *edit : findChildren<QLineEdit*>()) scaledFontWidgets << edit;
+    for (QLabel *lab : findChildren<QLabel*>()) scaledFontWidgets << lab;       // 左侧标签
+    for (QCheckBox *chk : findChildren<QCheckBox*>()) scaledFontWidgets << chk; // “同步表达式”“实时预览”复选框
+    scaledButtons = findChildren<QPushButton*>();
+    for (QPushButton *btn : scaledButtons) {
+        scaledFontWidgets << btn;
+        btn->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    }
+
+    // 拖动窗口边缘时连续的 resize 合并为一次缩放
+    rescaleTimer = new QTimer(this);
+    rescaleTimer->setSingleShot(true);
+    rescaleTimer->setInterval(30);
+    connect(rescaleTimer, &QTimer::timeout, this, &MainWindow::applyScale);
+
+    trace::phase("connections");
+
     // 初始化状态
     ui->editSplitRule->installEventFilter(this);
     setButtonEnabledByBase(currentBase);
     ui->chkSyncExpression->setChecked(false); // 默认仅更新数值
+    ui->chkLivePreview->setChecked(true);     // 默认实时预览
+    trace::phase("initial state");
 }
 
 MainWindow::~MainWindow()
@@ -128,51 +162,71 @@ MainWindow::~MainWindow()
 // -------------------------------
 void MainWindow::resizeEvent(QResizeEvent *event)
 {
+    TRACE_SCOPE("resizeEvent");
     QMainWindow::resizeEvent(event);
 
+    // 目标尺寸与已应用的相同时什么都不做；否则等拖动停下后按最终高度应用一次
+    int pointSize, buttonHeight;
+    scaleSizesFor(height(), pointSize, buttonHeight);
+    if (pointSize == appliedPointSize && buttonHeight == appliedButtonHeight) {
+        rescaleTimer->stop();
+        return;
+    }
+
+    // 首次显示时立即应用，避免先以设计时字号绘制一帧
+    if (appliedPointSize == 0) {
+        applyScale();
+        return;
+    }
+    rescaleTimer->start();
+}
+
+void MainWindow::scaleSizesFor(int windowHeight, int &pointSize, int &buttonHeight) const
+{
     // 以设计时高度 600 作为基准，按比例缩放
     const int baseHeight = 600;
-    const int currentH = height();
-    double scale = static_cast<double>(currentH) / baseHeight;
+    double scale = static_cast<double>(windowHeight) / baseHeight;
     if (scale < 0.7) scale = 0.7;
     if (scale > 1.6) scale = 1.6;
 
     // 缩放字体大小
     const int basePointSize = 10;
-    int newPointSize = static_cast<int>(basePointSize * scale);
-    if (newPointSize < 8) newPointSize = 8;
-    if (newPointSize > 18) newPointSize = 18;
+    pointSize = static_cast<int>(basePointSize * scale);
+    if (pointSize < 8) pointSize = 8;
+    if (pointSize > 18) pointSize = 18;
 
-    QFont f = this->font();
-    f.setPointSize(newPointSize);
+    // 按比例设置按钮最小高度
+    const int baseBtnMinH = 26;
+    buttonHeight = static_cast<int>(baseBtnMinH * scale);
+    if (buttonHeight < 20) buttonHeight = 20;
+}
 
-    // 应用到所有 QLineEdit
-    const auto lineEdits = findChildren<QLineEdit*>();
-    for (QLineEdit *edit : lineEdits) {
-        edit->setFont(f);
+void MainWindow::applyScale()
+{
+    TRACE_SCOPE("applyScale");
+    int pointSize, buttonHeight;
+    scaleSizesFor(height(), pointSize, buttonHeight);
+
+    // 批量修改期间暂停重绘，改完后只重新布局和绘制一次
+    setUpdatesEnabled(false);
+
+    if (pointSize != appliedPointSize) {
+        QFont f = this->font();
+        f.setPointSize(pointSize);
+        for (QWidget *widget : scaledFontWidgets) {
+            widget->setFont(f);
+        }
+        appliedPointSize = pointSize;
     }
 
-    // 应用到左侧标签和“同步表达式”复选框
-    const auto labels = findChildren<QLabel*>();
-    for (QLabel *lab : labels) {
-        lab->setFont(f);
-    }
-    const auto checks = findChildren<QCheckBox*>();
-    for (QCheckBox *chk : checks) {
-        chk->setFont(f);
+    if (buttonHeight != appliedButtonHeight) {
+        for (QPushButton *btn : scaledButtons) {
+            btn->setMinimumHeight(buttonHeight);
+        }
+        appliedButtonHeight = buttonHeight;
     }
 
-    // 应用到所有 QPushButton，并按比例设置最小高度
-    const int baseBtnMinH = 26;
-    int newBtnMinH = static_cast<int>(baseBtnMinH * scale);
-    if (newBtnMinH < 20) newBtnMinH = 20;
-
-    const auto buttons = findChildren<QPushButton*>();
-    for (QPushButton *btn : buttons) {
-        btn->setFont(f);
-        btn->setMinimumHeight(newBtnMinH);
-        btn->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-    }
+    setUpdatesEnabled(true);
 }
 
 // -------------------------------
@@ -441,6 +495,8 @@ bool MainWindow::eventFilter(QObject *obj, QEvent *event)
             setButtonEnabledByBase(currentBase);
             // 只要不是在编辑 SplitRule，逗号永远禁用
             if (ui->btnComma) ui->btnComma->setEnabled(false);
+            // 表达式按新的进制重新解释
+            updatePreview();
             qDebug() << "Switch to Base:" << currentBase;
         }
     }
@@ -6,8 +6,14 @@
 #include <QPushButton>
 #include <QLineEdit>
 
+#include "evaluator.h"
+#include "format.h"
+#include "splitlayout.h"
+#include "widevalue.h"
+
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
+class QTimer;
 QT_END_NAMESPACE
 
 class MainWindow : public QMainWindow
@@ -40,6 +46,7 @@ private slots:
     void onUpdateModeChanged(int value);
     void onClearClicked();
     void onResetClicked(); // 归零按钮处理
+    void onExpressionEvaluated(quint64 generation, int kind, const calc::Evaluation &result); // 后台求值的结果
 
 private:
     Ui::MainWindow *ui;
@@ -50,15 +57,55 @@ private:
     QMap<QString, QPushButton*> digitButtons;
     QMap<QString, QPushButton*> operatorButtons;
 
+    // 显示框，脏标记按位记录
+    enum DisplayField {
+        FieldDec        = 1 << 0,
+        FieldHex        = 1 << 1,
+        FieldOct        = 1 << 2,
+        FieldBin        = 1 << 3,
+        FieldBinResult  = 1 << 4,
+        FieldDecResult  = 1 << 5,
+        FieldHexResult  = 1 << 6,
+        FieldExpression = 1 << 7,  // 仅在"同步表达式"模式下由输入框更新
+        ValueFields     = FieldDec | FieldHex | FieldOct | FieldBin,
+        SplitFields     = FieldBinResult | FieldDecResult | FieldHexResult
+    };
+
+    // 显示模型：所有显示框都由同一个数值生成
+    // 数值变化只记下脏标记，每轮事件循环最多刷新一次，且只对文本真正变化的框调用 setText
+    // 位宽随分割规则取能容纳它的最小 64/128/256/512 位，数值按该位宽符号扩展存放
+    struct DisplayModel
+    {
+        calc::WideValue value;
+        int valueBits = 64;
+        bool valid = false;        // 清空后为假，刷新时不写任何框
+        uint dirty = 0;            // 待刷新的 DisplayField
+        Base expressionBase = DEC; // FieldExpression 脏时，表达式取该进制的显示文本
+        bool scheduled = false;    // 已安排本轮事件循环的刷新
+        QVector<int> changedParts; // 结果框逐段编辑时值变化的段（升序）；SplitFields 不脏时结果框只重写这些段
+    };
+
     void setButtonEnabledByBase(Base base);
-    void updateAllDisplays(long long value);
-    QString formatBinWithSplit(const QString &bin, const QString &rule);
+    void updateAllDisplays(const calc::WideValue &value); // 设置显示模型的数值，标记所有显示框待刷新
+    void setValueBits(int valueBits);        // 切换位宽，数值截到新位宽
+    void markDisplaysDirty(uint fields);     // 标记部分显示框待刷新（如分割规则变化只影响结果框）
+    void flushDisplays();                    // 重新生成显示文本，只写入内容变化的框
+    void setFieldText(QLineEdit *edit, const QString &text); // 文本不同才 setText，并保持光标位置
+    bool setChangedSplitFields(QLineEdit *edit, int base, const QVector<int> &parts); // 只替换结果框中的这些段，段数不符时返回 false
+
+    // 窗口缩放：控件列表只收集一次，字号或按钮高度真正变化时才应用，拖动过程中合并到最终尺寸
+    void scaleSizesFor(int windowHeight, int &pointSize, int &buttonHeight) const;
+    void applyScale();
+
+    QString formatBinWithSplit(long long value); // 按当前分割布局切分二进制
     QString formatBinWithSpaces(const QString &bin); // 每四位数字后加空格
-    long long evaluateExpression(const QString &expr, Base base);
-    void updateFromInputValue(long long value, Base inputBase = DEC);
+    void updatePreview(); // 实时预览：按当前进制、位宽和 x 提交后台增量求值，结果或错误显示在预览标签中
+    void showStatus(const QString &text, bool error); // 预览标签兼作按"="的状态提示，错误标红
+    void cancelCommit();  // 丢弃尚未回来的"="结果（清空、置零或用户改了输入之后它已过时）
+    void updateFromInputValue(const calc::WideValue &value, Base inputBase = DEC);
     void updateFromResultValue(const QString &resultText, Base resultBase);
-    bool checkValueOverflow(const QString &text, Base base); // 检查输入是否超出64位范围
-    bool validateExpression(const QString &expr, Base base, QString &errorMsg); // 检查表达式是否合法
+    bool checkValueOverflow(const QString &text, Base base); // 检查结果框输入（按段）是否超出当前位宽
+    void rejectOverflowInput();                              // 提示超出位宽并删掉最后输入的字符
     bool handleBinResultKeyEvent(QKeyEvent *keyEvent); // 处理二进制分割结果的键盘事件
     bool handleBinResultDigitInput(const QString &digit); // 处理二进制分割结果的数字输入（用于按钮点击）
     int findLeftDigitPos(const QString &text, int cursorPos); // 找到光标左边最近的数字位位置
@@ -67,6 +114,18 @@ private:
     QLineEdit* lastFocusedEdit; // 记录最后获得焦点的输入框
     bool isUpdating; // 防止循环更新
     int lastUpdateMode; // 记录上一次的更新模式
+    ExpressionEvaluator *evaluator;  // 后台求值（按"="与实时预览），界面线程不等待引擎
+    QTimer *busyTimer;               // 按"="后结果迟迟未回时才显示"计算中"，避免短暂闪烁
+    bool commitPending;              // 按"="的结果尚未回来，期间预览结果不覆盖状态提示
+    calc::SplitLayout splitLayout;   // 解析后的分割规则，仅在 editSplitRule 变化时重建
+    calc::DisplayStrings displayStrings; // 各显示框的文本，每次刷新复用；写入过显示框的字符串与之共享，下次刷新时重新分配
+    DisplayModel display;                // 当前数值与待刷新的显示框
+    QList<QWidget*> scaledFontWidgets;   // 随窗口缩放字体的输入框、标签、复选框和按钮
+    QList<QPushButton*> scaledButtons;   // 同时缩放最小高度的按钮
+    QTimer *rescaleTimer;                // 合并拖动过程中的 resize
+    int appliedPointSize;                // 已应用的字号和按钮最小高度，0 表示尚未应用
+    int appliedButtonHeight;
+    int styledBase;                      // 输入框高亮样式对应的进制，0 表示尚未设置
 };
 
 #endif // MAINWINDOW_H
@@ -1,29 +1,21 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
-#include <QMessageBox>
+
+#include "trace.h"
 
 // -------------------------------
 // 结果框文本变化处理
 // -------------------------------
 void MainWindow::onBinResultChanged(const QString &text)
 {
+    TRACE_SCOPE("onBinResultChanged");
     if (isUpdating) return;
+    cancelCommit();  // 用户输入的数值优先，尚未回来的"="结果作废
     if (text.isEmpty()) return;
 
-    // 检查是否超出64位范围
+    // 检查是否超出当前位宽
     if (checkValueOverflow(text, BIN)) {
-        QMessageBox::warning(this, "输入过多", "输入内容超出64位二进制数能表示的范围！");
-        // 阻止最后一个输入：删除最后一个字符
-        QLineEdit* edit = qobject_cast<QLineEdit*>(sender());
-        if (edit) {
-            QString currentText = edit->text();
-            if (!currentText.isEmpty()) {
-                currentText.chop(1);
-                isUpdating = true;
-                edit->setText(currentText);
-                isUpdating = false;
-            }
-        }
+        rejectOverflowInput();
         return;
     }
 
@@ -32,23 +24,14 @@ void MainWindow::onBinResultChanged(const QString &text)
 
 void MainWindow::onDecResultChanged(const QString &text)
 {
+    TRACE_SCOPE("onDecResultChanged");
     if (isUpdating) return;
+    cancelCommit();  // 用户输入的数值优先，尚未回来的"="结果作废
     if (text.isEmpty()) return;
 
-    // 检查是否超出64位范围
+    // 检查是否超出当前位宽
     if (checkValueOverflow(text, DEC)) {
-        QMessageBox::warning(this, "输入过多", "输入内容超出64位二进制数能表示的范围！");
-        // 阻止最后一个输入：删除最后一个字符
-        QLineEdit* edit = qobject_cast<QLineEdit*>(sender());
-        if (edit) {
-            QString currentText = edit->text();
-            if (!currentText.isEmpty()) {
-                currentText.chop(1);
-                isUpdating = true;
-                edit->setText(currentText);
-                isUpdating = false;
-            }
-        }
+        rejectOverflowInput();
         return;
     }
 
@@ -57,23 +40,14 @@ void MainWindow::onDecResultChanged(const QString &text)
 
 void MainWindow::onHexResultChanged(const QString &text)
 {
+    TRACE_SCOPE("onHexResultChanged");
     if (isUpdating) return;
+    cancelCommit();  // 用户输入的数值优先，尚未回来的"="结果作废
     if (text.isEmpty()) return;
 
-    // 检查是否超出64位范围
+    // 检查是否超出当前位宽
     if (checkValueOverflow(text, HEX)) {
-        QMessageBox::warning(this, "输入过多", "输入内容超出64位二进制数能表示的范围！");
-        // 阻止最后一个输入：删除最后一个字符
-        QLineEdit* edit = qobject_cast<QLineEdit*>(sender());
-        if (edit) {
-            QString currentText = edit->text();
-            if (!currentText.isEmpty()) {
-                currentText.chop(1);
-                isUpdating = true;
-                edit->setText(currentText);
-                isUpdating = false;
-            }
-        }
+        rejectOverflowInput();
         return;
     }
 
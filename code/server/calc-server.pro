@@ -0,0 +1,22 @@
+QT = core network
+
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+TARGET = calc-server
+
+include(../engine/engine.pri)
+
+SOURCES += \
+    main.cpp \
+    protocol.cpp \
+    server.cpp
+
+HEADERS += \
+    protocol.h \
+    server.h
+
+# Default rules for deployment.
+qnx: target.path = /tmp/cal/bin
+else: unix:!android: target.path = /opt/cal/bin
+!isEmpty(target.path): INSTALLS += target
@@ -0,0 +1,56 @@
+#include <QCoreApplication>
+#include <QString>
+
+#include <cstdio>
+#include <cstring>
+
+#include "server.h"
+
+// -------------------------------
+// calc-server：常驻的本地求值服务，避免每次计算都启动一个进程
+// -------------------------------
+namespace {
+
+const char DefaultName[] = "calc-server";
+
+void printUsage(FILE *out)
+{
+    fputs("用法: calc-server [选项]\n"
+          "在本地套接字上接受流水线式的求值请求（格式见 protocol.h），按请求的顺序应答。\n"
+          "\n"
+          "选项:\n"
+          "  -n, --name <名称>               套接字名称或路径（默认 calc-server，位于系统的临时目录）\n"
+          "  -h, --help                      显示本帮助\n", out);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QString name = QString::fromLatin1(DefaultName);
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        if (!strcmp(arg, "-h") || !strcmp(arg, "--help")) {
+            printUsage(stdout);
+            return 0;
+        } else if ((!strcmp(arg, "-n") || !strcmp(arg, "--name")) && i + 1 < argc) {
+            name = QString::fromLocal8Bit(argv[++i]);
+        } else {
+            fprintf(stderr, "calc-server: 未知选项: %s\n", arg);
+            printUsage(stderr);
+            return 2;
+        }
+    }
+
+    EvalServer server;
+    QString error;
+    if (!server.listen(name, error)) {
+        fprintf(stderr, "calc-server: 无法监听 %s: %s\n", name.toLocal8Bit().constData(),
+                error.toLocal8Bit().constData());
+        return 2;
+    }
+    fprintf(stderr, "calc-server: 正在监听 %s\n", server.fullServerName().toLocal8Bit().constData());
+    return app.exec();
+}
@@ -0,0 +1,180 @@
+#include "protocol.h"
+
+#include <QtEndian>
+
+#include <cstring>
+
+namespace {
+
+const int LengthBytes = 4;
+const int RequestHeaderBytes = 8;   // 进制、保留、位宽、表达式字节数、规则字节数
+const int ReplyHeaderBytes = 12;    // 状态、错误、位宽、出错位置、段数、提示字节数
+const int FieldHeaderBytes = 4;     // 段宽、保留
+
+// 位宽为 bits 的数值所占的 64 位字数，超出 MaxValueBits 的部分恒为 0，不传输
+inline int wordsFor(int bits)
+{
+    return (qMin(bits, calc::MaxValueBits) + 63) / 64;
+}
+
+// 按小端写入，返回写入后的位置
+template<typename T>
+char *put(char *out, T value)
+{
+    qToLittleEndian(value, out);
+    return out + sizeof(T);
+}
+
+char *putWords(char *out, const calc::WideValue &value, int words)
+{
+    for (int i = 0; i < words; ++i) out = put(out, value.limb[i]);
+    return out;
+}
+
+template<typename T>
+T get(const char *&in)
+{
+    const T value = qFromLittleEndian<T>(in);
+    in += sizeof(T);
+    return value;
+}
+
+calc::WideValue getWords(const char *&in, int words)
+{
+    calc::WideValue value;
+    for (int i = 0; i < words; ++i) value.limb[i] = get<quint64>(in);
+    return value;
+}
+
+// 读出帧体的范围；帧不完整或长度不合法时不移动 pos
+FrameResult takeFrame(const QByteArray &data, int &pos, const char *&body, int &size)
+{
+    if (data.size() - pos < LengthBytes) return FrameIncomplete;
+    const quint32 length = qFromLittleEndian<quint32>(data.constData() + pos);
+    if (length > quint32(MaxFrameBytes)) return FrameInvalid;
+    if (data.size() - pos - LengthBytes < int(length)) return FrameIncomplete;
+    body = data.constData() + pos + LengthBytes;
+    size = int(length);
+    pos += LengthBytes + int(length);
+    return FrameComplete;
+}
+
+} // namespace
+
+void appendRequest(QByteArray &out, const EvalRequest &request)
+{
+    const QByteArray expr = request.expr.toUtf8();
+    const QByteArray rule = request.rule.toUtf8();
+    const int length = RequestHeaderBytes + expr.size() + rule.size();
+    const int start = out.size();
+    out.resize(start + LengthBytes + length);
+
+    char *p = out.data() + start;
+    p = put(p, quint32(length));
+    p = put(p, quint8(request.base));
+    p = put(p, quint8(0));
+    p = put(p, quint16(request.valueBits));
+    p = put(p, quint16(expr.size()));
+    p = put(p, quint16(rule.size()));
+    memcpy(p, expr.constData(), size_t(expr.size()));
+    memcpy(p + expr.size(), rule.constData(), size_t(rule.size()));
+}
+
+FrameResult takeRequest(const QByteArray &data, int &pos, EvalRequest &request)
+{
+    const char *in = nullptr;
+    int size = 0;
+    int next = pos;
+    const FrameResult result = takeFrame(data, next, in, size);
+    if (result != FrameComplete) return result;
+    if (size < RequestHeaderBytes) return FrameInvalid;
+
+    request.base = get<quint8>(in);
+    get<quint8>(in);
+    request.valueBits = get<quint16>(in);
+    if (request.valueBits == 0) request.valueBits = 64;
+    const int exprBytes = get<quint16>(in);
+    const int ruleBytes = get<quint16>(in);
+    if (RequestHeaderBytes + exprBytes + ruleBytes != size) return FrameInvalid;
+    request.expr = QString::fromUtf8(in, exprBytes);
+    request.rule = QString::fromUtf8(in + exprBytes, ruleBytes);
+    pos = next;
+    return FrameComplete;
+}
+
+void appendReply(QByteArray &out, const EvalReply &reply)
+{
+    const QByteArray message = reply.message.toUtf8();
+    const bool ok = reply.status == ReplyOk;
+    int length = ReplyHeaderBytes;
+    if (ok) {
+        length += wordsFor(reply.valueBits) * 8;
+        for (const ReplyField &field : reply.fields) length += FieldHeaderBytes + wordsFor(field.width) * 8;
+    } else {
+        length += message.size();
+    }
+    const int start = out.size();
+    out.resize(start + LengthBytes + length);
+
+    char *p = out.data() + start;
+    p = put(p, quint32(length));
+    p = put(p, quint8(reply.status));
+    p = put(p, quint8(reply.error));
+    p = put(p, quint16(reply.valueBits));
+    p = put(p, qint32(reply.column));
+    p = put(p, quint16(ok ? reply.fields.size() : 0));
+    p = put(p, quint16(ok ? 0 : message.size()));
+    if (!ok) {
+        memcpy(p, message.constData(), size_t(message.size()));
+        return;
+    }
+    p = putWords(p, reply.value, wordsFor(reply.valueBits));
+    for (const ReplyField &field : reply.fields) {
+        p = put(p, quint16(field.width));
+        p = put(p, quint16(0));
+        p = putWords(p, field.value, wordsFor(field.width));
+    }
+}
+
+FrameResult takeReply(const QByteArray &data, int &pos, EvalReply &reply)
+{
+    const char *in = nullptr;
+    int size = 0;
+    int next = pos;
+    const FrameResult result = takeFrame(data, next, in, size);
+    if (result != FrameComplete) return result;
+    if (size < ReplyHeaderBytes) return FrameInvalid;
+    const char *const end = in + size;
+
+    reply.status = ReplyStatus(get<quint8>(in));
+    reply.error = get<quint8>(in);
+    reply.valueBits = get<quint16>(in);
+    reply.column = get<qint32>(in);
+    const int fieldCount = get<quint16>(in);
+    const int messageBytes = get<quint16>(in);
+    reply.fields.clear();
+    reply.message.clear();
+    reply.value = calc::WideValue();
+
+    if (reply.status != ReplyOk) {
+        if (messageBytes != end - in) return FrameInvalid;
+        reply.message = QString::fromUtf8(in, messageBytes);
+        pos = next;
+        return FrameComplete;
+    }
+
+    if (!calc::isValueBits(reply.valueBits) || end - in < wordsFor(reply.valueBits) * 8) return FrameInvalid;
+    reply.value = calc::truncateTo(getWords(in, wordsFor(reply.valueBits)), reply.valueBits);
+    reply.fields.resize(fieldCount);
+    for (ReplyField &field : reply.fields) {
+        if (end - in < FieldHeaderBytes) return FrameInvalid;
+        field.width = get<quint16>(in);
+        get<quint16>(in);
+        const int words = wordsFor(field.width);
+        if (end - in < words * 8) return FrameInvalid;
+        field.value = getWords(in, words);
+    }
+    if (in != end) return FrameInvalid;
+    pos = next;
+    return FrameComplete;
+}
@@ -0,0 +1,75 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include "widevalue.h"
+
+// -------------------------------
+// calc-server 的请求 / 应答格式（小端）
+// 每帧以 4 字节的帧体长度开头；客户端可以连续发送任意多个请求而不等应答，服务端按请求的顺序应答
+//
+//   请求  u8 进制（2/8/10/16）、u8 保留、u16 位宽（64/128/256/512，0 为 64）、
+//         u16 表达式字节数、u16 分割规则字节数、表达式（UTF-8）、分割规则（如 "1,2,4"，可为空）
+//   应答  u8 状态、u8 校验错误（ValidationError）、u16 位宽、i32 出错位置、u16 段数、u16 提示字节数，
+//         成功时随后是数值（位宽 / 64 个 64 位字，补码）和各段（u16 位宽、u16 保留、按位宽取整的 64 位字），
+//         失败时随后是提示文本（UTF-8，与界面的错误提示相同）
+// -------------------------------
+
+// 帧体的长度上限，超出视为协议错误并断开连接
+const int MaxFrameBytes = 1 << 20;
+// 表达式和分割规则各自的字节数上限（u16）
+const int MaxTextBytes = 0xFFFF;
+// 应答的段数上限：512 位的数值全按 1 位分割，另加剩余段
+const int MaxReplyFields = calc::MaxValueBits + 1;
+
+enum ReplyStatus {
+    ReplyOk,
+    ReplyInvalid,      // 字符层面的错误（同 validate），error 给出原因
+    ReplySyntaxError,  // 字符合法但语法错误（如 "3-*4"）
+    ReplyBadRequest    // 进制或位宽不受支持，或分割规则的段数过多
+};
+
+enum FrameResult {
+    FrameComplete,
+    FrameIncomplete,   // 数据不足一帧，等待更多数据
+    FrameInvalid       // 长度或字段不合法，无法继续解析
+};
+
+struct EvalRequest
+{
+    int base = 10;
+    int valueBits = 64;
+    QString expr;
+    QString rule;      // 为空时不分割
+};
+
+// 应答中的一段：与结果框相同的分割布局，数值按段宽取无符号
+struct ReplyField
+{
+    int width = 0;
+    calc::WideValue value;
+};
+
+struct EvalReply
+{
+    ReplyStatus status = ReplyOk;
+    int error = 0;            // calc::ValidationError
+    int valueBits = 64;
+    int column = -1;          // 出错字符在表达式中的下标
+    calc::WideValue value;    // 按位宽符号扩展
+    QVector<ReplyField> fields;
+    QString message;
+};
+
+// 追加一帧到 out
+void appendRequest(QByteArray &out, const EvalRequest &request);
+void appendReply(QByteArray &out, const EvalReply &reply);
+
+// 从 data 的 pos 处取一帧，成功时 pos 移到下一帧的开头
+FrameResult takeRequest(const QByteArray &data, int &pos, EvalRequest &request);
+FrameResult takeReply(const QByteArray &data, int &pos, EvalReply &reply);
+
+#endif // PROTOCOL_H
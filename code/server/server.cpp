@@ -0,0 +1,147 @@
+#include "server.h"
+
+#include "validator.h"
+
+namespace {
+
+// 未写出的应答超过 HighWater 时暂停处理请求，写出到 LowWater 以下再继续
+const qint64 HighWater = 4 << 20;
+const qint64 LowWater = 1 << 20;
+// 套接字接收缓冲区的上限：暂停期间不再从系统读取，客户端的写入随之阻塞
+const qint64 ReadBufferBytes = 1 << 20;
+
+// 各请求复用的 EvaluationCache 容量：服务端面对多个客户端，比界面的默认值大
+const int CacheCapacity = 4096;
+
+bool isBase(int base)
+{
+    return base == calc::BIN || base == calc::OCT || base == calc::DEC || base == calc::HEX;
+}
+
+} // namespace
+
+// -------------------------------
+// 连接
+// -------------------------------
+Connection::Connection(QLocalSocket *socket, calc::EvaluationCache &cache, QObject *parent)
+    : QObject(parent), socket(socket), cache(cache)
+{
+    socket->setParent(this);
+    socket->setReadBufferSize(ReadBufferBytes);
+    connect(socket, &QLocalSocket::readyRead, this, &Connection::process);
+    connect(socket, &QLocalSocket::bytesWritten, this, &Connection::process);
+    connect(socket, &QLocalSocket::disconnected, this, &QObject::deleteLater);
+}
+
+void Connection::process()
+{
+    // 写出还没跟上：先不读取，等 bytesWritten 再来
+    if (socket->bytesToWrite() > LowWater) return;
+
+    input.append(socket->readAll());
+    int pos = 0;
+    FrameResult result = FrameComplete;
+    while (socket->bytesToWrite() + output.size() < HighWater
+           && (result = takeRequest(input, pos, request)) == FrameComplete) {
+        evaluate(request, reply);
+        appendReply(output, reply);
+    }
+    input.remove(0, pos);
+
+    if (!output.isEmpty()) {
+        socket->write(output);
+        output.clear();
+    }
+    if (result == FrameInvalid) {
+        // 长度不可信，找不到下一帧：已有的应答写出后断开
+        input.clear();
+        socket->disconnectFromServer();
+    }
+}
+
+void Connection::evaluate(const EvalRequest &request, EvalReply &reply)
+{
+    reply.error = calc::NoError;
+    reply.valueBits = request.valueBits;
+    reply.column = -1;
+    reply.fields.clear();
+    reply.message.clear();
+
+    if (!isBase(request.base) || !calc::isValueBits(request.valueBits)) {
+        reply.status = ReplyBadRequest;
+        reply.message = QStringLiteral("不支持的进制或位宽");
+        return;
+    }
+
+    const calc::Evaluation result = cache.evaluate(QStringView(request.expr), request.base, request.valueBits);
+    if (!result.ok()) {
+        // 字符层面合法后再检查语法（如 "3-*4"、"()"），与界面的提示一致
+        reply.status = result.syntaxError ? ReplySyntaxError : ReplyInvalid;
+        reply.error = result.error;
+        reply.column = result.column;
+        reply.message = result.syntaxError ? QStringLiteral("表达式语法错误") : calc::validationMessage(result.error);
+        return;
+    }
+    reply.status = ReplyOk;
+    reply.value = result.value;
+    if (request.rule.isEmpty()) return;
+
+    // 与结果框相同的分割布局：按数值的位数（负数为整个位宽）切分，各段取无符号
+    const calc::SplitLayout &layout = layoutFor(request.rule);
+    const int valueBits = calc::bitLength(result.value, request.valueBits);
+    const int count = layout.fieldCount(valueBits);
+    if (count > MaxReplyFields) {
+        reply.status = ReplyBadRequest;
+        reply.message = QStringLiteral("分割规则的段数过多");
+        return;
+    }
+    const calc::WideValue value = calc::truncateTo(result.value, request.valueBits);
+    reply.fields.resize(count);
+    for (int i = 0; i < count; ++i) {
+        const calc::SplitField field = layout.field(i, valueBits);
+        reply.fields[i].width = field.width;
+        reply.fields[i].value = calc::SplitLayout::extract(value, field);
+    }
+}
+
+const calc::SplitLayout &Connection::layoutFor(const QString &rule)
+{
+    if (rule != lastRule) {
+        lastRule = rule;
+        lastLayout = calc::SplitLayout(QStringView(rule));
+    }
+    return lastLayout;
+}
+
+// -------------------------------
+// 监听
+// -------------------------------
+EvalServer::EvalServer(QObject *parent)
+    : QObject(parent), cache(CacheCapacity)
+{
+    connect(&server, &QLocalServer::newConnection, this, &EvalServer::onNewConnection);
+}
+
+bool EvalServer::listen(const QString &name, QString &error)
+{
+    if (server.listen(name)) return true;
+
+    // 上次异常退出留下的套接字文件：确认没有服务在监听后删除，再试一次
+    if (server.serverError() == QAbstractSocket::AddressInUseError) {
+        QLocalSocket probe;
+        probe.connectToServer(name);
+        if (probe.waitForConnected(1000)) {
+            error = QStringLiteral("已有服务在监听");
+            return false;
+        }
+        QLocalServer::removeServer(name);
+        if (server.listen(name)) return true;
+    }
+    error = server.errorString();
+    return false;
+}
+
+void EvalServer::onNewConnection()
+{
+    while (QLocalSocket *socket = server.nextPendingConnection()) new Connection(socket, cache, this);
+}
@@ -0,0 +1,66 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <QByteArray>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QObject>
+#include <QString>
+
+#include "evalcache.h"
+#include "protocol.h"
+#include "splitlayout.h"
+
+// -------------------------------
+// 一个客户端连接：读入的数据中有几个完整的请求就一次算完几个，应答按顺序攒成一批后一次写出
+// 客户端不必等应答就可以继续发送（流水线）；未写出的应答超过上限时暂停读取，
+// 由套接字的接收缓冲区把压力传回客户端，写出到下限以下再继续
+// -------------------------------
+class Connection : public QObject
+{
+    Q_OBJECT
+
+public:
+    Connection(QLocalSocket *socket, calc::EvaluationCache &cache, QObject *parent = nullptr);
+
+private slots:
+    void process();
+
+private:
+    void evaluate(const EvalRequest &request, EvalReply &reply);
+    const calc::SplitLayout &layoutFor(const QString &rule);
+
+    QLocalSocket *socket;
+    calc::EvaluationCache &cache;
+    QByteArray input;       // 已读入、尚未处理的数据
+    QByteArray output;      // 本批的应答
+    EvalRequest request;    // 各请求复用
+    EvalReply reply;
+    QString lastRule;       // 同一连接的请求通常使用同一条规则，只解析一次
+    calc::SplitLayout lastLayout;
+};
+
+// -------------------------------
+// calc-server：在本地套接字上监听，所有连接在同一个线程中处理，共用一个求值缓存
+// 求值与界面按"="相同（EvaluationCache：校验、编译、执行，变量 x 取 0），错误提示也相同
+// -------------------------------
+class EvalServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit EvalServer(QObject *parent = nullptr);
+
+    // 监听 name（不含 '/' 时放在系统的临时目录下）；同名的套接字已无服务时先删除
+    bool listen(const QString &name, QString &error);
+    QString fullServerName() const { return server.fullServerName(); }
+
+private slots:
+    void onNewConnection();
+
+private:
+    QLocalServer server;
+    calc::EvaluationCache cache;
+};
+
+#endif // SERVER_H
@@ -0,0 +1,182 @@
+#include "trace.h"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+
+#include <atomic>
+#include <cstdio>
+
+namespace trace {
+
+bool active = false;
+bool profilingStartup = false;
+
+namespace {
+
+// 环形缓冲区容量，按 2 的幂取模
+const quint64 Capacity = 1 << 16;
+
+struct Event
+{
+    const char *name;
+    qint64 startNs;
+    qint64 durationNs;
+    quint32 thread;
+};
+
+QElapsedTimer clock;
+Event *events = nullptr;
+std::atomic<quint64> written{0};  // 累计写入的事件数，取模得到下一个位置
+std::atomic<quint32> threads{0};
+QString outputPath;
+
+// 启动阶段，数量固定且很少
+const int MaxPhases = 32;
+
+struct Phase
+{
+    const char *name;
+    qint64 endNs;
+};
+
+Phase phases[MaxPhases];
+int phaseCount = 0;
+
+void startClock()
+{
+    if (!clock.isValid()) clock.start();
+}
+
+// 每个线程第一次记录时分配一个小编号，作为 trace 中的 tid
+quint32 threadId()
+{
+    thread_local quint32 id = ++threads;
+    return id;
+}
+
+void appendEscaped(QByteArray &out, const char *text)
+{
+    for (const char *p = text; *p; ++p) {
+        if (*p == '"' || *p == '\\') out += '\\';
+        out += *p;
+    }
+}
+
+// 纳秒转为 trace-event 使用的微秒，保留三位小数
+void appendMicros(QByteArray &out, qint64 ns)
+{
+    out += QByteArray::number(ns / 1000);
+    out += '.';
+    const QByteArray frac = QByteArray::number(ns % 1000);
+    out += QByteArray(3 - frac.size(), '0');
+    out += frac;
+}
+
+} // namespace
+
+void enable(const QString &path)
+{
+    if (active) return;
+    events = new Event[Capacity];
+    outputPath = path;
+    startClock();
+    active = true;
+}
+
+qint64 now()
+{
+    return clock.nsecsElapsed();
+}
+
+void record(const char *name, qint64 startNs, qint64 endNs)
+{
+    const quint64 index = written.fetch_add(1, std::memory_order_relaxed);
+    Event &event = events[index & (Capacity - 1)];
+    event.name = name;
+    event.startNs = startNs;
+    event.durationNs = endNs - startNs;
+    event.thread = threadId();
+}
+
+bool dump(const QString &path)
+{
+    if (!events) return false;
+
+    const quint64 total = written.load(std::memory_order_relaxed);
+    const quint64 first = total > Capacity ? total - Capacity : 0;
+
+    QByteArray out;
+    out.reserve(int(qMin(total, Capacity)) * 96 + 256);
+    out += "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped\":";
+    out += QByteArray::number(first);
+    out += "},\"traceEvents\":[\n";
+    out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"cal\"}}";
+    for (quint64 i = first; i < total; ++i) {
+        const Event &event = events[i & (Capacity - 1)];
+        out += ",\n{\"name\":\"";
+        appendEscaped(out, event.name);
+        out += "\",\"cat\":\"cal\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+        out += QByteArray::number(event.thread);
+        out += ",\"ts\":";
+        appendMicros(out, event.startNs);
+        out += ",\"dur\":";
+        appendMicros(out, event.durationNs);
+        out += '}';
+    }
+    out += "\n]}\n";
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+    return file.write(out) == out.size();
+}
+
+void dumpIfEnabled()
+{
+    if (active) dump(outputPath);
+}
+
+void startProfile()
+{
+    startClock();
+    profilingStartup = true;
+}
+
+void phase(const char *name)
+{
+    if (!profilingStartup || phaseCount == MaxPhases) return;
+    const qint64 end = now();
+    const qint64 start = phaseCount > 0 ? phases[phaseCount - 1].endNs : 0;
+    phases[phaseCount++] = Phase{name, end};
+    if (active) record(name, start, end);
+}
+
+void reportProfile()
+{
+    qint64 previous = 0;
+    fprintf(stderr, "startup profile (from main):\n");
+    for (int i = 0; i < phaseCount; ++i) {
+        fprintf(stderr, "  %-28s %8.2f ms\n", phases[i].name, double(phases[i].endNs - previous) / 1e6);
+        previous = phases[i].endNs;
+    }
+    fprintf(stderr, "  %-28s %8.2f ms\n", "total", double(previous) / 1e6);
+}
+
+const char *eventName(QEvent::Type type)
+{
+    switch (type) {
+    case QEvent::KeyPress:           return "KeyPress";
+    case QEvent::KeyRelease:         return "KeyRelease";
+    case QEvent::MouseButtonPress:   return "MouseButtonPress";
+    case QEvent::MouseButtonRelease: return "MouseButtonRelease";
+    case QEvent::InputMethod:        return "InputMethod";
+    case QEvent::Resize:             return "Resize";
+    case QEvent::LayoutRequest:      return "LayoutRequest";
+    case QEvent::UpdateRequest:      return "UpdateRequest";  // 顶层窗口的一次重绘（绘制全部脏区并刷新到屏幕）
+    case QEvent::Paint:              return "Paint";
+    case QEvent::Timer:              return "Timer";          // 包括合并后的显示刷新
+    default:                         return nullptr;
+    }
+}
+
+} // namespace trace
@@ -0,0 +1,73 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QEvent>
+#include <QString>
+
+// -------------------------------
+// 可选的耗时跟踪：记录热点槽函数、按键和重绘的起止时间，退出时导出为 Chrome trace-event JSON
+// 通过环境变量 CAL_TRACE=<文件> 或命令行 --trace <文件> 开启；未开启时每个跟踪点只有一次布尔判断
+// 事件写入固定大小的环形缓冲区，写满后覆盖最早的事件，不再分配内存
+// 用 chrome://tracing 或 https://ui.perfetto.dev 打开导出的文件
+// -------------------------------
+namespace trace {
+
+extern bool active;
+extern bool profilingStartup;
+
+inline bool enabled() { return active; }
+
+// 开启跟踪，程序退出时写入 outputPath
+void enable(const QString &outputPath);
+
+// 当前时间（纳秒，单调时钟）
+qint64 now();
+
+// 记录一段已结束的区间
+void record(const char *name, qint64 startNs, qint64 endNs);
+
+// 把缓冲区中的事件写成 Chrome trace-event JSON，失败返回 false
+bool dump(const QString &path);
+
+// 在开启时写入 enable() 指定的文件
+void dumpIfEnabled();
+
+// 需要跟踪处理耗时的事件（按键、鼠标、重绘），其余返回 nullptr
+const char *eventName(QEvent::Type type);
+
+// 作用域计时：构造时记下开始时间，析构时写入一段区间；name 须为静态字符串
+class Scope
+{
+public:
+    explicit Scope(const char *name) : name(enabled() ? name : nullptr), start(this->name ? now() : 0) {}
+    ~Scope() { if (name) record(name, start, now()); }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+private:
+    const char *name;
+    qint64 start;
+};
+
+// -------------------------------
+// 启动计时（--profile-startup）：从 main() 开始依次记下各阶段结束的时刻
+// 首帧绘制完成后把每个阶段的耗时输出到 stderr；同时开启跟踪时各阶段也写入跟踪
+// -------------------------------
+void startProfile();
+
+inline bool profiling() { return profilingStartup; }
+
+// 标记一个阶段结束（从上一个标记到现在）；name 须为静态字符串
+void phase(const char *name);
+
+// 输出各阶段耗时和总耗时
+void reportProfile();
+
+} // namespace trace
+
+#define TRACE_CONCAT2(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT2(a, b)
+#define TRACE_SCOPE(name) trace::Scope TRACE_CONCAT(traceScope, __LINE__)(name)
+
+#endif // TRACE_H
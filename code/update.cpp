@@ -1,7 +1,10 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 
-#include <QStringList>
+#include <algorithm>
+
+#include "radix.h"
+#include "trace.h"
 
 // -------------------------------
 // 更新模式变化处理（复选框）
@@ -42,66 +45,17 @@ void MainWindow::onUpdateModeChanged(int value)
 // -------------------------------
 // 从输入值更新所有显示
 // -------------------------------
-void MainWindow::updateFromInputValue(long long value, Base inputBase)
+void MainWindow::updateFromInputValue(const calc::WideValue &value, Base inputBase)
 {
-    isUpdating = true;
-
-    // 保存所有输入框的光标位置
-    QMap<QLineEdit*, int> cursorPositions;
-    cursorPositions[ui->editDec] = ui->editDec->cursorPosition();
-    cursorPositions[ui->editHex] = ui->editHex->cursorPosition();
-    cursorPositions[ui->editOct] = ui->editOct->cursorPosition();
-    cursorPositions[ui->editBin] = ui->editBin->cursorPosition();
-    cursorPositions[ui->editBinResult] = ui->editBinResult->cursorPosition();
-    cursorPositions[ui->editDecResult] = ui->editDecResult->cursorPosition();
-    cursorPositions[ui->editHexResult] = ui->editHexResult->cursorPosition();
-    cursorPositions[ui->editExpression] = ui->editExpression->cursorPosition();
-    cursorPositions[ui->editSplitRule] = ui->editSplitRule->cursorPosition();
-
-    // 保存当前的分割规则
-    QString splitRule = ui->editSplitRule->text();
-
-    // 更新所有基础显示
+    TRACE_SCOPE("updateFromInputValue");
+    // 只更新显示模型，各显示框在本轮事件循环结束前统一刷新，光标位置由 setFieldText 保持
     updateAllDisplays(value);
 
-    // 恢复分割规则（updateAllDisplays可能会触发onSplitRuleChanged，但我们已经保存了规则）
-    ui->editSplitRule->setText(splitRule);
-    
-    // 恢复所有输入框的光标位置
-    for (auto it = cursorPositions.begin(); it != cursorPositions.end(); ++it) {
-        QLineEdit* edit = it.key();
-        int savedPos = it.value();
-        int maxPos = edit->text().length();
-        int restorePos = qMin(savedPos, maxPos);
-        edit->setCursorPosition(restorePos);
-    }
-
-    // 根据复选框位置决定是否更新表达式
-    int updateMode = ui->chkSyncExpression->isChecked() ? 1 : 0;
-    if (updateMode == 1) { // 同步表达式模式
-        // 根据被修改的输入框，更新表达式
-        QString exprValue;
-        if (inputBase == HEX) {
-            exprValue = ui->editHex->text();
-        } else if (inputBase == DEC) {
-            exprValue = ui->editDec->text();
-        } else if (inputBase == OCT) {
-            exprValue = ui->editOct->text();
-        } else if (inputBase == BIN) {
-            exprValue = ui->editBin->text();
-        }
-
-        if (!exprValue.isEmpty()) {
-            int savedCursorPos = ui->editExpression->cursorPosition();
-            ui->editExpression->setText(exprValue);
-            int maxPos = ui->editExpression->text().length();
-            int restorePos = qMin(savedCursorPos, maxPos);
-            ui->editExpression->setCursorPosition(restorePos);
-        }
+    // 同步表达式模式下，表达式取被修改进制的显示文本；仅更新数值模式下不更新表达式
+    if (ui->chkSyncExpression->isChecked()) {
+        display.expressionBase = inputBase;
+        markDisplaysDirty(FieldExpression);
     }
-    // 如果updateMode == 0（仅更新数值），则不更新表达式
-
-    isUpdating = false;
 }
 
 // -------------------------------
@@ -109,186 +63,53 @@ void MainWindow::updateFromInputValue(long long value, Base inputBase)
 // -------------------------------
 void MainWindow::updateFromResultValue(const QString &resultText, Base resultBase)
 {
+    TRACE_SCOPE("updateFromResultValue");
     if (isUpdating) return;
     isUpdating = true;
 
-    // 保存当前焦点编辑框的光标位置
-    QLineEdit* focusedEdit = getFocusedEditBox();
-    int savedCursorPos = -1;
-    if (focusedEdit && (focusedEdit == ui->editBinResult || 
-                        focusedEdit == ui->editDecResult || 
-                        focusedEdit == ui->editHexResult)) {
-        savedCursorPos = focusedEdit->cursorPosition();
-    }
-
-    // 获取当前的分割规则和BIN结果
-    QString splitRule = ui->editSplitRule->text();
-    QString currentBinResult = ui->editBinResult->text();
-
-    // 如果分割规则为空，直接按单个值处理
-    if (splitRule.isEmpty() || !currentBinResult.contains('|')) {
-        bool ok;
-        long long value = 0;
-        QString cleanText = resultText;
-        if (resultBase == BIN) {
-            cleanText.remove(' '); // 移除空格
-            value = cleanText.replace("|", "").toLongLong(&ok, 2);
-        } else if (resultBase == DEC) {
-            value = cleanText.replace("|", "").toLongLong(&ok, 10);
-        } else if (resultBase == HEX) {
-            value = cleanText.replace("|", "").toLongLong(&ok, 16);
-        }
-
-        if (ok) {
-            updateAllDisplays(value);
-        }
-        // 恢复光标位置
-        if (savedCursorPos >= 0 && focusedEdit) {
-            int maxPos = focusedEdit->text().length();
-            int restorePos = qMin(savedCursorPos, maxPos);
-            focusedEdit->setCursorPosition(restorePos);
-        }
-        isUpdating = false;
-        return;
+    // 当前数值的位数决定高位剩余段的宽度（与formatBinWithSplit逻辑一致）
+    // 取显示模型中的数值：显示框可能还在等待本轮刷新
+    const calc::WideValue currentValue = display.valid ? display.value : calc::WideValue();
+    const int valueBits = calc::bitLength(currentValue, display.valueBits);
+    const int numParts = splitLayout.fieldCount(valueBits);
+
+    // 按分割结构逐段写回；没有分割，或结果段数与分割结构不匹配时，
+    // 把整个结果文本作为一个值解析（跳过空格和 |）
+    calc::WideValue totalValue;
+    const bool split = numParts > 1
+                       && calc::parseSplitParts(QStringView(resultText), splitLayout, valueBits, resultBase, totalValue);
+    bool ok = split;
+    if (split) {
+        totalValue = calc::truncateTo(totalValue, display.valueBits);
+    } else {
+        const calc::ParsedWideNumber<calc::MaxValueBits> parsed =
+            calc::parseNumber(QStringView(resultText), resultBase, display.valueBits);
+        ok = parsed.ok();
+        totalValue = parsed.value;
     }
-
-    // 获取当前BIN结果的段数（用于确定分割结构）
-    QStringList binParts = currentBinResult.split('|');
-    int numParts = binParts.size();
-
-    // 解析结果文本的每一段
-    QStringList resultParts = resultText.split('|');
-
-    // 如果结果段数不匹配，尝试按单个值处理
-    if (resultParts.size() != numParts) {
-        // 尝试将整个结果文本作为一个值解析
-        bool ok;
-        long long totalValue = 0;
-        QString cleanText = resultText;
-        if (resultBase == BIN) {
-            cleanText.remove(' '); // 移除空格
-            totalValue = cleanText.replace("|", "").toLongLong(&ok, 2);
-        } else if (resultBase == DEC) {
-            totalValue = cleanText.replace("|", "").toLongLong(&ok, 10);
-        } else if (resultBase == HEX) {
-            totalValue = cleanText.replace("|", "").toLongLong(&ok, 16);
-        }
-
-        if (ok) {
-            updateAllDisplays(totalValue);
-        }
-        // 恢复光标位置
-        if (savedCursorPos >= 0 && focusedEdit) {
-            int maxPos = focusedEdit->text().length();
-            int restorePos = qMin(savedCursorPos, maxPos);
-            focusedEdit->setCursorPosition(restorePos);
-        }
+    if (!ok) {
         isUpdating = false;
         return;
     }
 
-    // 解析分割规则，获取每段的位数
-    QStringList ruleStrings = splitRule.split(',');
-    QList<int> bitLengths;
-    int totalRuleLen = 0;
-    for (const QString& s : ruleStrings) {
-        bool ok;
-        int l = s.trimmed().toInt(&ok);
-        if (ok && l > 0) {
-            bitLengths << l;
-            totalRuleLen += l;
-        }
-    }
-
-    // 获取当前完整的二进制值，用于确定总长度
-    QString currentBin = ui->editBin->text();
-    currentBin.remove(' '); // 移除空格
-    int binLen = currentBin.length();
-
-    // 计算高位剩余部分的长度（与formatBinWithSplit逻辑一致）
-    int remainderLen = qMax(0, binLen - totalRuleLen);
-
-    // 计算总的二进制值
-    long long totalValue = 0;
-    int bitOffset = 0;
-
-    // 从高位到低位处理每一段
-    // 第一段可能是高位剩余部分
-    for (int i = 0; i < qMin(resultParts.size(), binParts.size()); i++) {
-        bool ok;
-        long long partValue = 0;
-
-        if (resultBase == BIN) {
-            QString cleanPart = resultParts[i];
-            cleanPart.remove(' '); // 移除空格
-            partValue = cleanPart.toLongLong(&ok, 2);
-        } else if (resultBase == DEC) {
-            partValue = resultParts[i].toLongLong(&ok, 10);
-        } else if (resultBase == HEX) {
-            partValue = resultParts[i].toLongLong(&ok, 16);
-        }
-
-        if (!ok) continue;
-
-        // 确定该段应该占用的位数
-        int bitLen = 0;
-        if (i == 0 && remainderLen > 0) {
-            // 第一段是高位剩余部分
-            bitLen = remainderLen;
-        } else {
-            // 其他段按规则分割
-            int ruleIndex = (remainderLen > 0) ? (i - 1) : i;
-            if (ruleIndex >= 0 && ruleIndex < bitLengths.size()) {
-                bitLen = bitLengths[ruleIndex];
-            } else if (!binParts[i].isEmpty()) {
-                // 如果没有规则，使用当前段的长度
-                bitLen = binParts[i].length();
-            }
-        }
-
-        if (bitLen == 0) continue;
-
-        // 计算该段能表示的最大值
-        long long maxValue = (1LL << bitLen) - 1;
-
-        // 如果值超出范围，截取低位
-        if (partValue > maxValue) {
-            partValue = partValue & maxValue;
-        }
-
-        // 计算该段在总二进制中的位置（从低位开始）
-        // binParts是从高位到低位的顺序，所以需要计算该段之后所有段的位数
-        int currentBitOffset = 0;
-
-        // 计算该段之后的所有段的位数（从低位开始，即从最后一个段开始）
-        for (int j = resultParts.size() - 1; j > i; j--) {
-            int segBitLen = 0;
-            if (j == 0 && remainderLen > 0) {
-                segBitLen = remainderLen;
-            } else {
-                int ruleIdx = (remainderLen > 0) ? (j - 1) : j;
-                if (ruleIdx >= 0 && ruleIdx < bitLengths.size()) {
-                    segBitLen = bitLengths[ruleIdx];
-                } else if (j < binParts.size() && !binParts[j].isEmpty()) {
-                    segBitLen = binParts[j].length();
-                }
+    // 逐段编辑且各段的位宽不变（剩余段的宽度由数值位数决定）时，结果框只重写值变化的段，
+    // 不必重新生成上百段的文本；其余情况更新所有显示（光标位置由 setFieldText 保持）
+    const int newBits = calc::bitLength(totalValue, display.valueBits);
+    const int ruleBits = splitLayout.totalBits();
+    if (split && display.valid && !(display.dirty & SplitFields)
+        && qMax(valueBits, ruleBits) == qMax(newBits, ruleBits)) {
+        for (int i = 0; i < numParts; ++i) {
+            const calc::SplitField field = splitLayout.field(i, valueBits);
+            if (calc::SplitLayout::extract(currentValue, field) != calc::SplitLayout::extract(totalValue, field)
+                && !display.changedParts.contains(i)) {
+                display.changedParts.append(i);
             }
-            currentBitOffset += segBitLen;
         }
-
-        // 将这段值放到正确的位置（从低位开始）
-        totalValue |= (partValue << currentBitOffset);
-    }
-
-    // 更新所有显示
-    updateAllDisplays(totalValue);
-
-    // 恢复光标位置
-    if (savedCursorPos >= 0 && focusedEdit) {
-        // 确保光标位置不超过新文本的长度
-        int maxPos = focusedEdit->text().length();
-        int restorePos = qMin(savedCursorPos, maxPos);
-        focusedEdit->setCursorPosition(restorePos);
+        std::sort(display.changedParts.begin(), display.changedParts.end());
+        display.value = totalValue;
+        markDisplaysDirty(ValueFields);
+    } else {
+        updateAllDisplays(totalValue);
     }
 
     isUpdating = false;